@@ -14,6 +14,7 @@ var connectionModule = (function () {
   var tableModule = require('./table').tableModule
   var userModule = require('./user').userModule
   var metaModule = require('./meta').metaModule
+  var poolModule = require('./pool').poolModule
 
   var sqlMeta = new metaModule.Meta()
   var userTypes = new userModule.SqlTypes()
@@ -146,6 +147,7 @@ var connectionModule = (function () {
         chunky.callback = new FilteredCb(chunky.callback, true)
       }
       queryRawNotify(notify, queryOrObj, chunky)
+      notifier.abortOn(notify, queryOrObj.signal)
       return notify
     }
 
@@ -162,6 +164,7 @@ var connectionModule = (function () {
         chunky.callback = new FilteredCb(chunky.callback, true)
       }
       queryNotify(notify, queryOrObj, chunky)
+      notifier.abortOn(notify, queryOrObj.signal)
       return notify
     }
 
@@ -174,22 +177,34 @@ var connectionModule = (function () {
       driverMgr.beginTransaction(callback)
     }
 
+    // callback (err, alive) with alive false once the connection is closed or has dropped.
+
+    function isAlive (callback) {
+      callback = callback || defaultCallback
+      if (dead) {
+        setImmediate(function () {
+          callback(null, false)
+        })
+        return
+      }
+      driverMgr.isAlive(callback)
+    }
+
     function cancelQuery (notify, callback) {
       if (dead) {
         throw new Error('[msnodesql] Connection is closed.')
       }
       var qid = notify.getQueryId()
-      var qo = notify.getQueryObj()
-      var polling = qo.query_polling || false
       callback = callback || defaultCallback
-      if (!polling) {
-        setImmediate(function () {
-          callback(new Error('Error: [msnodesql] cancel only supported for statements where polling is enabled.'))
-        })
-      }
       driverMgr.cancel(qid, callback)
     }
 
+    // {operations, bindMicros, executeMicros, boundBytes} summed over the life of the connection.
+
+    function nativeTimings () {
+      return driverMgr.timings()
+    }
+
     function commit (callback) {
       if (dead) {
         throw new Error('[msnodesql] Connection is closed.')
@@ -210,6 +225,103 @@ var connectionModule = (function () {
       driverMgr.rollback(callback)
     }
 
+    // bulkCopy(table, rows | columns, [options], callback) where options may set batchSize,
+    // tableLock, keepIdentity and checkConstraints. callback (err, rowsCopied).
+
+    function bulkCopy (table, rowsOrColumns, options, callback) {
+      if (dead) {
+        throw new Error('[msnodesql] Connection is closed.')
+      }
+      if (typeof options === 'function') {
+        callback = options
+        options = {}
+      }
+      options = options || {}
+      callback = callback || defaultCallback
+
+      t.bind(table, function (bulkMgr) {
+        bulkMgr.bulkCopy(rowsOrColumns, options, callback)
+      })
+    }
+
+    // importFile(path, table, [options], callback) loads a delimited utf8 file natively.
+    // options: delimiter (','), quote ('"'), header (true), columnMap and the bulkCopy options.
+
+    function importFile (path, table, options, callback) {
+      if (dead) {
+        throw new Error('[msnodesql] Connection is closed.')
+      }
+      if (typeof options === 'function') {
+        callback = options
+        options = {}
+      }
+      options = options || {}
+      callback = callback || defaultCallback
+
+      t.bind(table, function (bulkMgr) {
+        bulkMgr.importFile(path, options, callback)
+      })
+    }
+
+    // exportQuery(sql, [params], options, callback) writes the rows of every result set of
+    // the query as csv or ndjson without building any row objects. options: format ('csv' |
+    // 'ndjson'), delimiter, and fd or writable for the output. callback (err, rowsExported).
+
+    function exportQuery (queryOrObj, params, options, callback) {
+      if (dead) {
+        throw new Error('[msnodesql] Connection is closed.')
+      }
+      if (!Array.isArray(params)) {
+        callback = options
+        options = params
+        params = []
+      }
+      options = options || {}
+      callback = callback || defaultCallback
+
+      var notify = new notifier.StreamEvents()
+      notify.setConn(this)
+      notify.setQueryObj(queryOrObj)
+      var queryObj = notifier.validateQuery(queryOrObj, useUTC, 'exportQuery')
+      driverMgr.exportQuery(notify, queryObj, params, options, callback)
+      return notify
+    }
+
+    // queryAll(sql, [params], [options], callback) runs the query and reads every result in a
+    // single native call. No row or column events are raised. options: maxRows and maxBytes
+    // cap what is read, the row that would pass either left out and the results flagged
+    // truncated, and signal an AbortSignal.
+    // callback (err, sets, outputParams, truncated), each set { meta, rows, rowcount }.
+
+    function queryAll (queryOrObj, params, options, callback) {
+      if (dead) {
+        throw new Error('[msnodesql] Connection is closed.')
+      }
+      if (typeof params === 'function') {
+        callback = params
+        params = []
+        options = {}
+      } else if (!Array.isArray(params)) {
+        callback = options
+        options = params
+        params = []
+      }
+      if (typeof options === 'function') {
+        callback = options
+        options = {}
+      }
+      options = options || {}
+      callback = callback || defaultCallback
+
+      var notify = new notifier.StreamEvents()
+      notify.setConn(this)
+      notify.setQueryObj(queryOrObj)
+      var queryObj = notifier.validateQuery(queryOrObj, useUTC, 'queryAll')
+      driverMgr.queryAll(notify, queryObj, params, options, callback)
+      notifier.abortOn(notify, queryOrObj.signal || options.signal)
+      return notify
+    }
+
     // inform driver to prepare the sql statement and reserve it for repeated use with parameters.
 
     function PreparedStatement (preparedSignature, connection, preparedNotifier, preparedMeta) {
@@ -231,7 +343,9 @@ var connectionModule = (function () {
         return notify.getQueryId()
       }
 
-      function preparedQuery (paramsOrCallback, callback) {
+      // options.signal, an AbortSignal, cancels this execution when aborted.
+
+      function preparedQuery (paramsOrCallback, callback, options) {
         if (!active) {
           if (callback) {
             callback(new Error('error; prepared statement has been released.'))
@@ -254,6 +368,7 @@ var connectionModule = (function () {
         } else {
           driverMgr.readAllPrepared(notify, {}, chunky.params)
         }
+        notifier.abortOn(notify, options && options.signal)
 
         return notify
       }
@@ -299,21 +414,27 @@ var connectionModule = (function () {
       id: id,
       getUserTypeTable: getUserTypeTable,
       cancelQuery: cancelQuery,
+      nativeTimings: nativeTimings,
       queryNotify: queryNotify,
       queryRawNotify: queryRawNotify,
       close: close,
       queryRaw: queryRaw,
       query: query,
       beginTransaction: beginTransaction,
+      isAlive: isAlive,
       commit: commit,
       rollback: rollback,
+      bulkCopy: bulkCopy,
+      importFile: importFile,
+      exportQuery: exportQuery,
+      queryAll: queryAll,
       tableMgr: tableMgr,
       procedureMgr: procedureMgr,
       prepare: prepare,
       setUseUTC: setUseUTC
     }
 
-    t = new tableModule.TableMgr(publicApi, sqlMeta, userTypes)
+    t = new tableModule.TableMgr(publicApi, sqlMeta, userTypes, driverMgr)
     p = new procedureModule.ProcedureMgr(publicApi, notifier, driverMgr, sqlMeta)
 
     return publicApi
@@ -345,6 +466,7 @@ var connectionModule = (function () {
       var connection = new ConnectionWrapper(driverMgr, defaultCallback, id)
       connection.setUseUTC(true)
       var connectObj = p
+      driverMgr.setMars(!!connectObj.mars)
 
       function open () {
         nf.validateParameters(
@@ -451,12 +573,61 @@ var connectionModule = (function () {
     return openFrom('open', params, callback)
   }
 
+  // threads the driver runs odbc calls on, each connection queued to one of them. must be set
+  // before the first connection is opened; returns false once the threads have started.
+
+  function setWorkerThreads (size) {
+    return cppDriver.setWorkerThreads(size)
+  }
+
+  function getWorkerThreads () {
+    return cppDriver.workerThreads()
+  }
+
+  // priority classes [{ name, weight, maxRunning }] the driver workers share their time
+  // between, by weight, with at most maxRunning of a class's operations running at once. A
+  // query names its class and tenant with query_priority and query_tenant, a connection for
+  // all of its operations with priority and tenant; the first class takes the rest. Must be
+  // set before the first connection is opened; returns false once they are in use.
+
+  function setSchedulerClasses (classes) {
+    return cppDriver.setSchedulerClasses(classes.map(function (c) {
+      return {
+        name: c.name,
+        weight: c.weight > 0 ? c.weight : 1,
+        maxRunning: c.maxRunning > 0 ? c.maxRunning : 0
+      }
+    }))
+  }
+
+  // per class, operations queued and running now, and those dispatched so far with the time
+  // they spent queued for a worker.
+
+  function getSchedulerStats () {
+    return cppDriver.schedulerStats().map(function (s) {
+      s.waitMsAvg = s.dispatched > 0 ? s.waitMicrosTotal / s.dispatched / 1000 : 0
+      s.waitMsMax = s.waitMicrosMax / 1000
+      return s
+    })
+  }
+
+  // a pool of connections opened with the options' connectionString, see pool.js.
+
+  function Pool (options) {
+    return poolModule.Pool(open, options)
+  }
+
   return {
     meta: sqlMeta,
     userTypes: userTypes,
     query: query,
     queryRaw: queryRaw,
-    open: open
+    open: open,
+    Pool: Pool,
+    setWorkerThreads: setWorkerThreads,
+    getWorkerThreads: getWorkerThreads,
+    setSchedulerClasses: setSchedulerClasses,
+    getSchedulerStats: getSchedulerStats
   }
 }())
 
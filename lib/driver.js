@@ -5,6 +5,7 @@
 var driverModule = (function () {
   var readerModule = require('./reader').readerModule
   var queueModule = require('./queue').queueModule
+  var fs = require('fs')
 
   function DriverMgr (sql) {
     var driverCommandEnum = {
@@ -16,43 +17,116 @@ var driverModule = (function () {
       FREE_STATEMENT: 15,
       QUERY: 16,
       CLOSE: 17,
-      UNBIND: 18
+      UNBIND: 18,
+      BULK_COPY: 19,
+      EXPORT: 20,
+      IS_ALIVE: 21,
+      OPEN_LANE: 22
     }
 
     var cppDriver = sql
     var workQueue = new queueModule.WorkQueue()
     var reader = new readerModule.DriverRead(cppDriver, workQueue)
+    var useUTC = true
+
+    // with multiple active result sets each statement has a queue of its own, keeping its
+    // operations in order while other statements run alongside it. commands on the connection
+    // as a whole stay on workQueue. a statement started while a transaction command is pending
+    // has its queue held shut until that command completes.
+    var mars = false
+    var lanes = {}
+    var laneCount = 0
+    var lanesIdle = []
+    var connectionCommandsPending = 0
+
+    function setMars (enabled) {
+      mars = enabled
+    }
+
+    function queueFor (queryId) {
+      if (!mars) {
+        return workQueue
+      }
+      var lane = lanes[queryId]
+      if (!lane) {
+        lane = new queueModule.WorkQueue(function () {
+          if (lanes[queryId] !== lane) {
+            return
+          }
+          delete lanes[queryId]
+          laneCount -= 1
+          if (laneCount === 0) {
+            var waiting = lanesIdle
+            lanesIdle = []
+            waiting.forEach(function (fn) {
+              fn()
+            })
+          }
+        })
+        lanes[queryId] = lane
+        if (connectionCommandsPending > 0) {
+          lane.enqueue(driverCommandEnum.OPEN_LANE, function () {
+          }, [])
+          workQueue.enqueue(driverCommandEnum.OPEN_LANE, function () {
+            laneCount += 1
+            lane.nextOp()
+            workQueue.nextOp()
+          }, [])
+        } else {
+          laneCount += 1
+        }
+      }
+      return lane
+    }
+
+    function whenLanesIdle (fn) {
+      if (laneCount === 0) {
+        fn()
+      } else {
+        lanesIdle.push(fn)
+      }
+    }
 
     function setUseUTC (utc) {
+      useUTC = utc
       reader.setUseUTC(utc)
     }
 
     function emptyQueue () {
       workQueue.emptyQueue()
+      Object.keys(lanes).forEach(function (id) {
+        lanes[id].emptyQueue()
+      })
+      lanes = {}
+      laneCount = 0
+      lanesIdle = []
+      connectionCommandsPending = 0
     }
 
+    // statements still running on their own queues complete before the connection closes.
+
     function close (callback) {
       workQueue.enqueue(driverCommandEnum.CLOSE, function (cb) {
-        cppDriver.close(cb)
+        whenLanesIdle(function () {
+          cppDriver.close(cb)
+        })
       }, [callback])
     }
 
-    function execCancel (qid, i, callback) {
+    function execCancel (queue, qid, i, callback) {
       // send cancel directly to driver.
-      var currentItem = workQueue.get(i)
+      var currentItem = queue.get(i)
       var args = currentItem.args
       var cb = args[3]
 
       if (i === 0) {
-        cppDriver.pollingMode(qid, true, function () {
-          cppDriver.cancelQuery(qid, function (err) {
-            setImmediate(function () {
-              callback(err)
-            })
+        cppDriver.cancelQuery(qid, function (err) {
+          setImmediate(function () {
+            callback(err)
           })
         })
       } else {
-        workQueue.dropItem(i)
+        queue.dropItem(i)
         setImmediate(function () {
           // make a callback on the cancel request with no error.
           callback(null)
@@ -67,7 +141,8 @@ var driverModule = (function () {
     // the cancel, else the query can be removed from the queue and never submitted to the driver.
 
     function cancel (qid, callback) {
-      if (workQueue.length() === 0) {
+      var queue = mars && lanes[qid] ? lanes[qid] : workQueue
+      if (queue.length() === 0) {
         setImmediate(function () {
           callback(new Error('Error: [msnodesql] cannot cancel query (empty queue) id ' + qid))
         })
@@ -76,7 +151,7 @@ var driverModule = (function () {
 
       var i = -1
 
-      var first = workQueue.first(function (idx, currentItem) {
+      var first = queue.first(function (idx, currentItem) {
         if (currentItem.commandId !== driverCommandEnum.QUERY) {
           return false
         }
@@ -88,7 +163,7 @@ var driverModule = (function () {
       })
 
       if (first) {
-        execCancel(qid, i, callback)
+        execCancel(queue, qid, i, callback)
       } else {
         setImmediate(function () {
           callback(new Error('Error: [msnodesql] cannot cancel query (not found) id ' + qid))
@@ -120,6 +195,77 @@ var driverModule = (function () {
       return cppDriver.query(queryId, query, params, onQuery)
     }
 
+    // a table value parameter fed from a row source has its first chunk bound with the
+    // statement. If more rows follow, the parameter is sent at execution and each further
+    // chunk is put while the driver waits, after which results are read as usual.
+
+    function streamedTvp (params) {
+      var i
+      for (i = 0; params && i < params.length; i += 1) {
+        if (params[i] && params[i].row_source) {
+          return params[i]
+        }
+      }
+      return null
+    }
+
+    function putTvpRows (queryId, source, callback) {
+      source.chunks.next(function (err, rows, done) {
+        if (err) {
+          cppDriver.putTvpRows(queryId, [], -1, function () {
+            callback(err, [], false)
+          })
+          return
+        }
+
+        function onPut (err, results, more) {
+          if (err || rows.length === 0) {
+            callback(err, results, more)
+          } else if (done) {
+            cppDriver.putTvpRows(queryId, [], 0, callback)
+          } else {
+            putTvpRows(queryId, source, callback)
+          }
+        }
+
+        var chunk = rows.length > 0
+          ? [source.columns(rows)]
+          : []
+        cppDriver.putTvpRows(queryId, chunk, rows.length, onPut)
+      })
+    }
+
+    function beginStreamed (begin) {
+      return function (queryId, query, params, callback) {
+        var tp = streamedTvp(params)
+        if (!tp) {
+          return begin(queryId, query, params, callback)
+        }
+        var source = tp.row_source
+        source.chunks.next(function (err, rows, done) {
+          if (err) {
+            callback(err, [], false)
+            return
+          }
+          tp.table_value_param = [source.columns(rows)]
+          tp.row_count = rows.length
+          if (done) {
+            delete tp.chunk_size
+            begin(queryId, query, params, callback)
+            return
+          }
+          tp.chunk_size = source.chunk_size
+          begin(queryId, query, params, function (err, results, more) {
+            if (err) {
+              callback(err, results, more)
+              return
+            }
+            putTvpRows(queryId, source, callback)
+          })
+        })
+      }
+    }
+
     function procedureInternal (queryId, procedure, params, callback) {
       function onProc (err, results, params) {
         if (callback) {
@@ -175,27 +321,36 @@ var driverModule = (function () {
     }
 
     function freeStatement (queryId, callback) {
+      var queue = queueFor(queryId)
       function onFree () {
         callback(queryId)
-        workQueue.nextOp()
+        queue.nextOp()
       }
 
-      workQueue.enqueue(driverCommandEnum.FREE_STATEMENT, function (cb) {
+      queue.enqueue(driverCommandEnum.FREE_STATEMENT, function (cb) {
         cppDriver.freeStatement(queryId, cb)
       }, [onFree])
     }
 
+    // totals of native parameter binding and odbc execution over the life of the connection.
+
+    function timings () {
+      return cppDriver.timings()
+    }
+
     function cbNextStatement (queryId, outputParams, callback, results, more) {
       if (callback) {
         callback(null, results, more, outputParams)
       }
       if (!more) {
-        workQueue.nextOp()
+        queueFor(queryId).nextOp()
       }
     }
 
-    function cbFreeStatement (queryId, outputParams, callback, results, more) {
-      if (!more) {
+    // finished is set when the last result read has already freed the statement natively.
+
+    function cbFreeStatement (queryId, outputParams, callback, results, more, finished) {
+      if (!more && !finished) {
         freeStatement(queryId, function () {
         })
       }
@@ -205,14 +360,20 @@ var driverModule = (function () {
       }
     }
 
-    function procUnbind (queryId, outputParams, callback, results, more) {
+    function procUnbind (queryId, outputParams, callback, results, more, finished) {
+      if (finished) {
+        cbFreeStatement(queryId, outputParams, callback, results, more, finished)
+        return
+      }
+
+      var queue = queueFor(queryId)
       function onUnbind (err, op) {
         outputParams = op
         cbFreeStatement(queryId, outputParams, callback, results, more)
-        workQueue.nextOp()
+        queue.nextOp()
       }
 
-      workQueue.enqueue(driverCommandEnum.UNBIND, function (cb) {
+      queue.enqueue(driverCommandEnum.UNBIND, function (cb) {
         cppDriver.unbind(queryId, cb)
       }, [onUnbind])
     }
@@ -220,8 +381,10 @@ var driverModule = (function () {
     function readallProc (notify, query, params, callback) {
       setImmediate(function () {
         reader.fetch(notify, query, params, {
-          begin: procedureInternal,
-          end: procUnbind
+          begin: beginStreamed(procedureInternal),
+          end: procUnbind,
+          finish: { free: true, unbind: true },
+          queue: queueFor(notify.getQueryId())
         }, callback)
       })
     }
@@ -229,8 +392,10 @@ var driverModule = (function () {
     function readallQuery (notify, query, params, callback) {
       setImmediate(function () {
         reader.fetch(notify, query, params, {
-          begin: queryInternal,
-          end: cbFreeStatement
+          begin: beginStreamed(queryInternal),
+          end: cbFreeStatement,
+          finish: { free: true, unbind: false },
+          queue: queueFor(notify.getQueryId())
         }, callback)
       })
     }
@@ -239,7 +404,8 @@ var driverModule = (function () {
       setImmediate(function () {
         reader.fetch(notify, query, params, {
           begin: preparedInternal,
-          end: cbNextStatement
+          end: cbNextStatement,
+          queue: queueFor(notify.getQueryId())
         }, callback)
       })
     }
@@ -248,60 +414,244 @@ var driverModule = (function () {
     // only be unbound when rest of query completes. The output params
     // will now be ready to fetch out of the statement.
 
-    function beginTransaction (callback) {
-      function onBegin (err) {
-        callback(err)
+    // begin, commit, rollback and bulk copy work on the connection rather than a statement,
+    // so like close they wait for statements running on their own queues, and statements
+    // sent meanwhile wait for them. callback gets every argument the command gave.
+
+    function connectionCommand (commandId, fn, callback) {
+      function onDone () {
+        connectionCommandsPending -= 1
+        callback.apply(null, arguments)
         workQueue.nextOp()
       }
 
-      workQueue.enqueue(driverCommandEnum.BEGIN_TRANSACTION, function (cb) {
+      connectionCommandsPending += 1
+      workQueue.enqueue(commandId, function (cb) {
+        whenLanesIdle(function () {
+          fn(cb)
+        })
+      }, [onDone])
+    }
+
+    function beginTransaction (callback) {
+      connectionCommand(driverCommandEnum.BEGIN_TRANSACTION, function (cb) {
         cppDriver.beginTransaction(cb)
-      }, [onBegin])
+      }, callback)
     }
 
-    function rollback (callback) {
-      function onRollback (err) {
-        callback(err)
+    // asks the driver whether the connection has dropped, without a round trip to the server.
+
+    function isAlive (callback) {
+      function onAlive (err, alive) {
+        callback(err, !err && alive)
         workQueue.nextOp()
       }
 
-      workQueue.enqueue(driverCommandEnum.ROLLBACK, function (cb) {
+      workQueue.enqueue(driverCommandEnum.IS_ALIVE, function (cb) {
+        cppDriver.isAlive(cb)
+      }, [onAlive])
+    }
+
+    function rollback (callback) {
+      connectionCommand(driverCommandEnum.ROLLBACK, function (cb) {
         cppDriver.rollback(cb)
-      }, [onRollback])
+      }, callback)
     }
 
     function commit (callback) {
-      function onCommit (err) {
-        callback(err)
-        workQueue.nextOp()
+      connectionCommand(driverCommandEnum.COMMIT, function (cb) {
+        cppDriver.commit(cb)
+      }, callback)
+    }
+
+    // rows copied straight into the table by the driver bcp api, calling back with the row
+    // count. importFile is sent the same way.
+
+    function bulkCopy (bcpObj, params, callback) {
+      connectionCommand(driverCommandEnum.BULK_COPY, function (cb) {
+        cppDriver.bulkCopy(bcpObj, params, cb)
+      }, callback)
+    }
+
+    // run the query and have the driver fetch each result set with columns as csv or ndjson
+    // text, one after the other, a csv set starting with its own header row. chunks are
+    // written to the file descriptor or the Writable, the next chunk fetched once the write
+    // completes or the Writable drains. 'submitted', 'meta' for each set exported and 'done'
+    // are raised on notify. callback (err, rowsExported).
+
+    function exportQuery (notify, queryObj, params, options, callback) {
+      var queryId = notify.getQueryId()
+      var writable = options.writable
+      var fd = typeof options.fd === 'number' ? options.fd : -1
+      var exportObj = {
+        format: options.format === 'ndjson' ? 'ndjson' : 'csv',
+        delimiter: (options.delimiter || ',').charCodeAt(0),
+        chunk_bytes: options.chunkBytes > 0 ? options.chunkBytes : 1024 * 1024
       }
 
-      workQueue.enqueue(driverCommandEnum.COMMIT, function (cb) {
-        cppDriver.commit(cb)
-      }, [onCommit])
+      var queue = queueFor(queryId)
+      var rows = 0
+
+      function finish (err) {
+        cppDriver.freeStatement(queryId, function () {
+          if (!err) {
+            notify.emit('done')
+          }
+          callback(err, rows)
+          queue.nextOp()
+        })
+      }
+
+      function writeAll (data, offset, done) {
+        fs.write(fd, data, offset, data.length - offset, null, function (err, written) {
+          if (err) {
+            done(err)
+          } else if (offset + written < data.length) {
+            writeAll(data, offset + written, done)
+          } else {
+            done(null)
+          }
+        })
+      }
+
+      function output (data, done) {
+        if (!data) {
+          done(null)
+        } else if (fd >= 0) {
+          writeAll(data, 0, done)
+        } else if (!writable || writable.write(data)) {
+          done(null)
+        } else {
+          writable.once('drain', function () {
+            done(null)
+          })
+        }
+      }
+
+      function step () {
+        cppDriver.exportRows(queryId, exportObj, function (err, res) {
+          if (err) {
+            finish(err)
+            return
+          }
+          rows += res.rows
+          output(res.data, function (err) {
+            if (err) {
+              finish(err)
+            } else if (res.end) {
+              nextSet()
+            } else {
+              step()
+            }
+          })
+        })
+      }
+
+      function nextSet () {
+        cppDriver.nextResult(queryId, function (err, res) {
+          if (err || res.endOfResults) {
+            finish(err)
+          } else {
+            onResult(null, res.meta)
+          }
+        })
+      }
+
+      function onResult (err, meta) {
+        if (err) {
+          finish(err)
+        } else if (meta.length > 0) {
+          notify.emit('meta', meta)
+          step()
+        } else {
+          nextSet()
+        }
+      }
+
+      queue.enqueue(driverCommandEnum.EXPORT, function () {
+        cppDriver.query(queryId, queryObj, params, onResult)
+        notify.emit('submitted', queryObj, params)
+      }, [])
+    }
+
+    // execute the query and have the driver read every result, unbind output parameters and
+    // free the statement in one call, rather than a round trip per row and column. Only
+    // 'submitted', 'info' and 'done' are raised on notify. callback (err, sets, outputParams,
+    // truncated) where each set is { meta, rows, rowcount } with rows as arrays of values.
+
+    function queryAll (notify, queryObj, params, options, callback) {
+      var queryId = notify.getQueryId()
+      var allObj = {
+        max_rows: options.maxRows > 0 ? options.maxRows : 0,
+        max_bytes: options.maxBytes > 0 ? options.maxBytes : 0
+      }
+      var queue = queueFor(queryId)
+
+      function localDates (set) {
+        set.meta.forEach(function (m, column) {
+          if (m.type !== 'date') {
+            return
+          }
+          set.rows.forEach(function (row) {
+            var data = row[column]
+            if (data) {
+              row[column] = readerModule.localDate(data)
+            }
+          })
+        })
+      }
+
+      function onAll (err, res) {
+        if (err) {
+          callback(err, [], null, false)
+          queue.nextOp()
+          return
+        }
+        var first = null
+        res.errors.forEach(function (e) {
+          var info = e.sqlstate && e.sqlstate.substring(0, 2) === '01'
+          if (info) {
+            notify.emit('info', e)
+          } else if (!first) {
+            first = e
+          }
+        })
+        if (useUTC === false) {
+          res.sets.forEach(localDates)
+        }
+        notify.emit('done')
+        callback(first, res.sets, res.outputParams, res.truncated)
+        queue.nextOp()
+      }
+
+      queue.enqueue(driverCommandEnum.QUERY, function () {
+        cppDriver.queryAll(queryId, queryObj, params, allObj, onAll)
+        notify.emit('submitted', queryObj, params)
+      }, [notify, queryObj, params, callback])
     }
 
     function prepare (notify, queryOrObj, callback) {
+      var queue = queueFor(notify.getQueryId())
       function onPrepare (err, meta) {
         callback(err, meta)
-        workQueue.nextOp()
+        queue.nextOp()
       }
 
-      workQueue.enqueue(driverCommandEnum.PREPARE, function (cb) {
+      queue.enqueue(driverCommandEnum.PREPARE, function (cb) {
         prepareQuery(notify, queryOrObj, cb)
       }, [onPrepare])
     }
 
     function readAllPrepared (notify, queryObj, params, cb) {
-      workQueue.enqueue(driverCommandEnum.QUERY, readallPrepared, [notify, queryObj, params, cb])
+      queueFor(notify.getQueryId()).enqueue(driverCommandEnum.QUERY, readallPrepared, [notify, queryObj, params, cb])
     }
 
     function readAllQuery (notify, queryObj, params, cb) {
-      workQueue.enqueue(driverCommandEnum.QUERY, readallQuery, [notify, queryObj, params, cb])
+      queueFor(notify.getQueryId()).enqueue(driverCommandEnum.QUERY, readallQuery, [notify, queryObj, params, cb])
     }
 
     function realAllProc (notify, queryObj, params, cb) {
-      workQueue.enqueue(driverCommandEnum.QUERY, readallProc, [notify, queryObj, params, cb])
+      queueFor(notify.getQueryId()).enqueue(driverCommandEnum.QUERY, readallProc, [notify, queryObj, params, cb])
     }
 
     return {
@@ -310,9 +660,15 @@ var driverModule = (function () {
       commit: commit,
       rollback: rollback,
       beginTransaction: beginTransaction,
+      isAlive: isAlive,
+      bulkCopy: bulkCopy,
+      exportQuery: exportQuery,
+      queryAll: queryAll,
+      setMars: setMars,
       prepare: prepare,
       objectify: objectify,
       freeStatement: freeStatement,
+      timings: timings,
       readAllQuery: readAllQuery,
       realAllProc: realAllProc,
       readAllPrepared: readAllPrepared,
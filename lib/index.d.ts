@@ -5,6 +5,11 @@
 export interface SqlClient {
     open(description: ConnectDescription, cb: OpenCb): void
     open(conn_str: string, cb: OpenCb): void
+    setWorkerThreads(size: number): boolean
+    getWorkerThreads(): number
+    setSchedulerClasses(classes: SchedulerClass[]): boolean
+    getSchedulerStats(): SchedulerStats[]
+    Pool(options: PoolOptions): Pool
     query(conn_str: string, sql: string, cb?: QueryCb): Query
     query(conn_str: string, sql: string, params?: any[], cb?: QueryCb): Query
     query(conn_str: string, description: QueryDescription, cb?: QueryCb): Query
@@ -19,10 +24,10 @@ export interface SqlClient {
     TinyInt(v:number): any
     SmallInt(v:number): any
     Float(v:number): any
-    Numeric(v:number): any
-    Money(v:number): any
-    SmallMoney(v:number): any
-    Decimal(v:number): any
+    Numeric(v:number|string, precision?:number, scale?:number): any
+    Money(v:number|string): any
+    SmallMoney(v:number|string): any
+    Decimal(v:number|string, precision?:number, scale?:number): any
     Double(v:number): any
     Real(v:number): any
     WVarChar(v:String) : any
@@ -50,6 +55,35 @@ export interface SqlClient {
     TimeoutQuery(s:string, to:number) : QueryDescription
     TzOffsetQuery(s:string, offsetMinutes?:number) : QueryDescription,
     TvpFromTable(table:Table) : ProcedureParam
+    TvpFromStream(table:Table, source:any, chunkSize?:number) : ProcedureParam
+    RowLayout(columns:PackedColumn[]) : RowLayout
+    PackedRows(buffer:Buffer, layout:RowLayout, rows?:number) : any
+}
+
+export interface PackedColumn {
+    name?: string
+    type: string
+    length?: number
+    precision?: number
+    scale?: number
+}
+
+export interface PackedColumnLayout {
+    name: string
+    type: string
+    c_type: number
+    sql_type: number
+    precision: number
+    scale: number
+    size: number
+    offset: number
+    ind_offset: number
+}
+
+export interface RowLayout {
+    row_size: number
+    ind_size: number
+    columns: PackedColumnLayout[]
 }
 
 export interface Table {
@@ -89,6 +123,7 @@ export interface Connection {
     setUseUTC(utc:boolean):void
     getUseUTC():boolean
     close(cb: StatusCb): void
+    isAlive(cb: IsAliveCb): void
     query(sql: string, cb?: QueryCb): Query
     query(sql: string, params?: any[], cb?: QueryCb): Query
     query(description: QueryDescription, cb?: QueryCb): Query
@@ -100,10 +135,20 @@ export interface Connection {
     beginTransaction(cb?: StatusCb): void
     commit(cb?: StatusCb): void
     rollback(cb?: StatusCb): void
+    bulkCopy(table: string, rowsOrColumns: any, cb: BulkCopyCb): void
+    bulkCopy(table: string, rowsOrColumns: any, options: BulkCopyOptions, cb: BulkCopyCb): void
+    importFile(path: string, table: string, cb: BulkCopyCb): void
+    importFile(path: string, table: string, options: ImportFileOptions, cb: BulkCopyCb): void
+    exportQuery(sql: string, options: ExportOptions, cb: ExportCb): Query
+    exportQuery(sql: string, params: any[], options: ExportOptions, cb: ExportCb): Query
+    queryAll(sql: string | QueryDescription, cb: QueryAllCb): Query
+    queryAll(sql: string | QueryDescription, params: any[], cb: QueryAllCb): Query
+    queryAll(sql: string | QueryDescription, params: any[], options: QueryAllOptions, cb: QueryAllCb): Query
     procedureMgr(): ProcedureManager
     tableMgr(): TableManager
     pollingMode(q: Query, v:boolean, cb?: SimpleCb): void
     cancelQuery(q: Query, cb?: StatusCb): void
+    nativeTimings(): NativeTimings
     prepare(sql: string, cb: PrepareCb): void
     prepare(description: QueryDescription, cb: PrepareCb): void
     setFilterNonCriticalErrors(flag:boolean):void
@@ -118,7 +163,12 @@ export interface Query {
 
 export interface ConnectDescription {
     conn_str: string,
-    conn_timeout: number
+    conn_timeout: number,
+    // multiple active result sets: statements run concurrently rather than one at a time.
+    mars?: boolean,
+    // scheduler class and tenant for every operation on the connection, see setSchedulerClasses.
+    priority?: string,
+    tenant?: string
 }
 
 export interface QueryDescription {
@@ -126,6 +176,38 @@ export interface QueryDescription {
     query_timeout?: number,
     query_polling?: boolean,
     query_tz_adjustment?: number,
+    query_priority?: string,
+    query_tenant?: string,
+    signal?: AbortSignalLike
+}
+
+export interface SchedulerClass {
+    name: string
+    weight?: number
+    maxRunning?: number
+}
+
+export interface SchedulerStats {
+    name: string
+    weight: number
+    maxRunning: number
+    queued: number
+    running: number
+    dispatched: number
+    waitMicrosTotal: number
+    waitMicrosMax: number
+    waitMsAvg: number
+    waitMsMax: number
+}
+
+export interface AbortSignalLike {
+    aborted: boolean
+    addEventListener(type: 'abort', listener: () => void): void
+    removeEventListener(type: 'abort', listener: () => void): void
+}
+
+export interface CancelOptions {
+    signal?: AbortSignalLike
 }
 
 export interface Meta {
@@ -173,6 +255,18 @@ export interface EventColumnCb { (colIndex: number, data:any, more:boolean): voi
 }
 export interface BulkSelectCb { (err: Error, rows: any[]): void
 }
+export interface UpsertCounts {
+    inserted: number
+    updated: number
+}
+export interface UpsertCb { (err: Error, counts: UpsertCounts): void
+}
+export interface ExportCb { (err: Error, rowsExported: number): void
+}
+export interface QueryAllCb { (err: Error, sets: QueryAllSet[], outputParams: any[], truncated: boolean): void
+}
+export interface BulkCopyCb { (err: Error, rowsCopied: number): void
+}
 export interface DescribeProcedureCb { (description?: ProcedureSummary): void
 }
 export interface GetProcedureCb { (procedure?: ProcedureDefinition): void
@@ -186,16 +280,143 @@ export interface BulkMgrSummary {
     deleteSignature: string
     updateSignature: string
     columns: TableColumn[]
+    batchSize: number
+    adaptiveBatchSize: boolean
+    rowsPerSecond: number
+    batchLatencyMs: number
+}
+
+export interface NativeTimings {
+    operations: number
+    bindMicros: number
+    executeMicros: number
+    boundBytes: number
+}
+
+export interface BulkProgress {
+    operation: string
+    batches: number
+    rows: number
+    failedBatches: number
+    failedRows: number
+    totalRows: number
+    // boundBytes, bindMs and executeMs are measured from the connection totals and also
+    // count other statements completing on a batch's connection while it runs.
+    boundBytes: number
+    prepareMs: number
+    bindMs: number
+    executeMs: number
+    elapsedMs: number
+    rowsPerSecond: number
+    error?: Error
+}
+
+export interface AdaptiveBatchOptions {
+    min?: number
+    max?: number
+    targetMs?: number
+    targetBytes?: number
+}
+
+export interface ParallelOptions {
+    staged?: boolean
+}
+
+export interface BulkCopyOptions {
+    batchSize?: number
+    tableLock?: boolean
+    keepIdentity?: boolean
+    checkConstraints?: boolean
+}
+
+export interface ImportFileOptions extends BulkCopyOptions {
+    delimiter?: string
+    quote?: string
+    header?: boolean
+    columnMap?: any
+}
+
+export interface ExportOptions {
+    format?: string
+    delimiter?: string
+    fd?: number
+    writable?: NodeJS.WritableStream
+    chunkBytes?: number
+}
+
+export interface IsAliveCb { (err: Error, alive: boolean): void
+}
+
+export interface PoolOptions {
+    connectionString: string
+    floor?: number
+    ceiling?: number
+    acquireTimeoutMs?: number
+    idleTimeoutMs?: number
+    scanIntervalMs?: number
+    checkAlive?: boolean
+    useUTC?: boolean
+}
+
+export interface PoolMetrics {
+    size: number
+    idle: number
+    busy: number
+    waiting: number
+    floor: number
+    ceiling: number
+    utilization: number
+    acquires: number
+    timeouts: number
+    created: number
+    evicted: number
+    dead: number
+    acquireMsAvg: number
+    acquireMsMax: number
+}
+
+export interface Pool {
+    open(cb?: (err: Error, pool: Pool) => void): void
+    acquire(cb: (err: Error, conn: Connection) => void): void
+    acquire(timeoutMs: number, cb: (err: Error, conn: Connection) => void): void
+    release(conn: Connection): void
+    use(fn: (conn: Connection, done: (...args: any[]) => void) => void, cb?: (...args: any[]) => void): void
+    close(cb?: StatusCb): void
+    getMetrics(): PoolMetrics
+    on(event: 'open', listener: (pool: Pool) => void): void
+    on(event: 'error', listener: (err: Error) => void): void
+    removeListener(event: 'open' | 'error', listener: (...args: any[]) => void): void
+}
+
+export interface QueryAllOptions {
+    maxRows?: number
+    maxBytes?: number
+    signal?: AbortSignalLike
+}
+
+export interface QueryAllSet {
+    meta: Meta[]
+    rows: any[][]
+    rowcount: number
 }
 
 export interface BulkTableMgr {
+    on(event: 'progress' | 'summary', listener: (progress: BulkProgress) => void): void
+    removeListener(event: 'progress' | 'summary', listener: (progress: BulkProgress) => void): void
     getSummary(): BulkMgrSummary
     asUserType(name:string): string
     selectRows(cols: any[], cb: BulkSelectCb): void
     insertRows(rows: any[], cb: StatusCb): void
     deleteRows(rows: any[], cb: StatusCb): void
     updateRows(rows: any[], cb: StatusCb): void
+    upsertRows(rows: any[], cb: UpsertCb): void
+    bulkCopy(rowsOrColumns: any, options: BulkCopyOptions, cb: BulkCopyCb): void
+    importFile(path: string, options: ImportFileOptions, cb: BulkCopyCb): void
     setBatchSize(size: number): void
+    setAdaptiveBatchSize(options: AdaptiveBatchOptions): void
+    setParallel(connections: Connection[], degree?: number, options?: ParallelOptions): void
+    setJoinThreshold(rows: number): void
+    setSelectJoinThreshold(keys: number): void
     setWhereCols(cols: any[]): void
     setUpdateCols(cols: any[]): void
 }
@@ -253,7 +474,7 @@ export interface ProcedureSummary {
 
 export interface ProcedureManager {
     get(name:string, cb?:GetProcedureCb):void
-    callproc(name: string, params?: any[], cb?: CallProcedureCb): Query
+    callproc(name: string, params?: any[], cb?: CallProcedureCb, options?: CancelOptions): Query
     describe(name: string, cb?: DescribeProcedureCb): void
     setTimeout(timeout: number): void
     setPolling(poll:boolean):void;
@@ -261,10 +482,15 @@ export interface ProcedureManager {
 
 export interface TableManager {
     bind(tableName: string, cb: BindCb): void
+    createInsertStream(tableName: string, options?: InsertStreamOptions): NodeJS.WritableStream
+}
+
+export interface InsertStreamOptions {
+    batchSize?: number
 }
 
 export interface PreparedStatement {
-    preparedQuery(params?: any[], cb ?: QueryCb): Query
+    preparedQuery(params?: any[], cb ?: QueryCb, options?: CancelOptions): Query
     free(cb: StatusCb): void
     getSignature(): string
     getId(): number
@@ -102,6 +102,30 @@ var notifyModule = (function () {
       })
     }
 
+    // cancel the query when the AbortSignal is aborted, or as soon as it is queued if it
+    // already has been. the listener is dropped once the query is done; a late abort finds
+    // nothing to cancel.
+
+    function abortOn (notify, signal) {
+      if (!signal) {
+        return
+      }
+
+      function onAbort () {
+        notify.cancelQuery(function () {
+        })
+      }
+
+      if (signal.aborted) {
+        setImmediate(onAbort)
+        return
+      }
+      signal.addEventListener('abort', onAbort)
+      notify.once('done', function () {
+        signal.removeEventListener('abort', onAbort)
+      })
+    }
+
     function validateQuery (queryOrObj, useUTC, parentFn) {
       var queryObj = getQueryObject(queryOrObj, useUTC)
       validateParameters(
@@ -121,6 +145,7 @@ var notifyModule = (function () {
       StreamEvents: StreamEvents,
       validateParameters: validateParameters,
       getChunkyArgs: getChunkyArgs,
+      abortOn: abortOn,
       validateQuery: validateQuery
     }
   }
@@ -0,0 +1,344 @@
+// a pool of open connections handed to callers in turn. connections are opened in parallel up
+// to the floor when the pool opens, grown on demand to the ceiling and closed again once idle
+// for too long. Each connection keeps its native statement cache across acquires, and is asked
+// of the driver whether it has dropped before being handed out, so a broken one is replaced
+// rather than failing the caller's query.
+
+'use strict'
+
+var events = require('events')
+
+var poolModule = (function () {
+  function Pool (openFn, poolOptions) {
+    var options = poolOptions || {}
+    var connStr = options.connectionString
+    var floor = options.floor > 0 ? options.floor : 0
+    var ceiling = options.ceiling > 0 ? Math.max(options.ceiling, floor) : Math.max(4, floor)
+    var acquireTimeoutMs = options.acquireTimeoutMs >= 0 ? options.acquireTimeoutMs : 30000
+    var idleTimeoutMs = options.idleTimeoutMs >= 0 ? options.idleTimeoutMs : 30000
+    var scanIntervalMs = options.scanIntervalMs > 0 ? options.scanIntervalMs : 1000
+    var checkAlive = options.checkAlive !== false
+    var useUTC = options.useUTC !== false
+
+    var emitter = new events.EventEmitter()
+    var idle = [] // { conn, since }, the most recently released last
+    var busy = []
+    var waiters = [] // { callback, start, timer } served first come first served
+    var opening = 0
+    var checking = 0
+    var closed = false
+    var scanTimer = null
+
+    var counts = {
+      acquires: 0,
+      timeouts: 0,
+      created: 0,
+      evicted: 0,
+      dead: 0,
+      acquireMsTotal: 0,
+      acquireMsMax: 0
+    }
+
+    function size () {
+      return idle.length + busy.length + opening + checking
+    }
+
+    function emit (event, arg) {
+      if (event !== 'error' || emitter.listenerCount('error') > 0) {
+        emitter.emit(event, arg)
+      }
+    }
+
+    function closeConn (conn) {
+      conn.close(function () {
+      })
+    }
+
+    function grant (waiter, conn) {
+      if (waiter.timer) {
+        clearTimeout(waiter.timer)
+      }
+      var ms = Date.now() - waiter.start
+      counts.acquires += 1
+      counts.acquireMsTotal += ms
+      counts.acquireMsMax = Math.max(counts.acquireMsMax, ms)
+      busy.push(conn)
+      waiter.callback(null, conn)
+    }
+
+    function failWaiter (err) {
+      var waiter = waiters.shift()
+      if (waiter) {
+        if (waiter.timer) {
+          clearTimeout(waiter.timer)
+        }
+        waiter.callback(err, null)
+      }
+    }
+
+    // hand the idle connection to the first waiter once the driver confirms it is still
+    // connected; one found dead is closed and the waiter goes back to the front.
+
+    function check (waiter, entry) {
+      if (!checkAlive) {
+        grant(waiter, entry.conn)
+        return
+      }
+      checking += 1
+      entry.conn.isAlive(function (err, alive) {
+        checking -= 1
+        if (!err && alive && !closed) {
+          grant(waiter, entry.conn)
+          return
+        }
+        counts.dead += 1
+        closeConn(entry.conn)
+        if (closed) {
+          waiter.callback(new Error('[msnodesql] pool is closed.'), null)
+          return
+        }
+        waiters.unshift(waiter)
+        dispatch()
+      })
+    }
+
+    function dispatch () {
+      while (waiters.length > 0 && idle.length > 0) {
+        check(waiters.shift(), idle.pop())
+      }
+      var short = Math.min(waiters.length - opening, ceiling - size())
+      for (var i = 0; i < short; i += 1) {
+        grow(true)
+      }
+    }
+
+    // a connection opened for a waiter that fails fails the first waiter; one opened to keep
+    // the floor only reports the error on the pool.
+
+    function grow (forWaiter, callback) {
+      opening += 1
+      openFn(connStr, function (err, conn) {
+        opening -= 1
+        if (err) {
+          emit('error', err)
+          if (forWaiter) {
+            failWaiter(err)
+          }
+        } else if (closed) {
+          closeConn(conn)
+        } else {
+          counts.created += 1
+          idle.push({ conn: conn, since: Date.now() })
+          dispatch()
+        }
+        if (callback) {
+          callback(err)
+        }
+      })
+    }
+
+    // close connections idle past the timeout, oldest first, keeping the floor, and open
+    // replacements when dead connections have taken the pool below it.
+
+    function scan () {
+      var now = Date.now()
+      while (idleTimeoutMs > 0 && idle.length > 0 && size() > floor && now - idle[0].since > idleTimeoutMs) {
+        counts.evicted += 1
+        closeConn(idle.shift().conn)
+      }
+      var short = floor - size()
+      for (var i = 0; i < short; i += 1) {
+        grow(false)
+      }
+    }
+
+    // open the floor's connections in parallel. callback (err, pool) once all have completed.
+
+    function open (callback) {
+      var pending = floor
+      var first = null
+      callback = callback || function () {
+      }
+
+      function done (err) {
+        first = first || err
+        pending -= 1
+        if (pending <= 0) {
+          emit('open', publicApi)
+          callback(first, publicApi)
+        }
+      }
+
+      if (!scanTimer) {
+        scanTimer = setInterval(scan, scanIntervalMs)
+        if (scanTimer.unref) {
+          scanTimer.unref()
+        }
+      }
+      if (pending === 0) {
+        pending = 1
+        setImmediate(done)
+        return
+      }
+      for (var i = 0; i < floor; i += 1) {
+        grow(false, done)
+      }
+    }
+
+    // callback (err, conn), the connection to be given back through release. Waiters are
+    // served in the order they asked; timeoutMs 0 waits indefinitely.
+
+    function acquire (timeoutMs, callback) {
+      if (typeof timeoutMs === 'function') {
+        callback = timeoutMs
+        timeoutMs = acquireTimeoutMs
+      }
+      if (closed) {
+        setImmediate(function () {
+          callback(new Error('[msnodesql] pool is closed.'), null)
+        })
+        return
+      }
+      var waiter = {
+        callback: callback,
+        start: Date.now(),
+        timer: null
+      }
+      if (timeoutMs > 0) {
+        waiter.timer = setTimeout(function () {
+          var i = waiters.indexOf(waiter)
+          if (i >= 0) {
+            waiters.splice(i, 1)
+            counts.timeouts += 1
+            callback(new Error('[msnodesql] timed out after ' + timeoutMs + 'ms waiting for a pooled connection.'), null)
+          }
+        }, timeoutMs)
+      }
+      waiters.push(waiter)
+      dispatch()
+    }
+
+    // a connection given back has the settings a caller may have changed put back as the
+    // pool opened it, before the next caller is handed it.
+
+    function release (conn) {
+      var i = busy.indexOf(conn)
+      if (i < 0) {
+        return
+      }
+      busy.splice(i, 1)
+      if (closed) {
+        closeConn(conn)
+        return
+      }
+      conn.setUseUTC(useUTC)
+      idle.push({ conn: conn, since: Date.now() })
+      dispatch()
+    }
+
+    // acquire a connection for fn (conn, done). done (err, ...) may be given straight to a
+    // query as its callback: every call is passed on to callback, and the connection is
+    // released on the first call whose third argument, more, is not true.
+
+    function use (fn, callback) {
+      acquire(function (err, conn) {
+        if (err) {
+          if (callback) {
+            callback(err)
+          }
+          return
+        }
+        var released = false
+        fn(conn, function (err, res, more) {
+          if (!released && more !== true) {
+            released = true
+            release(conn)
+          }
+          if (callback) {
+            callback.apply(null, arguments)
+          }
+        })
+      })
+    }
+
+    function getMetrics () {
+      return {
+        size: size(),
+        idle: idle.length,
+        busy: busy.length,
+        waiting: waiters.length,
+        floor: floor,
+        ceiling: ceiling,
+        utilization: busy.length / ceiling,
+        acquires: counts.acquires,
+        timeouts: counts.timeouts,
+        created: counts.created,
+        evicted: counts.evicted,
+        dead: counts.dead,
+        acquireMsAvg: counts.acquires > 0 ? counts.acquireMsTotal / counts.acquires : 0,
+        acquireMsMax: counts.acquireMsMax
+      }
+    }
+
+    // waiters are failed and idle connections closed; busy ones close as they are released.
+
+    function close (callback) {
+      closed = true
+      if (scanTimer) {
+        clearInterval(scanTimer)
+        scanTimer = null
+      }
+      while (waiters.length > 0) {
+        failWaiter(new Error('[msnodesql] pool is closed.'))
+      }
+      var pending = idle.length
+      var conns = idle.map(function (entry) {
+        return entry.conn
+      })
+      idle = []
+      if (pending === 0) {
+        setImmediate(function () {
+          if (callback) {
+            callback(null)
+          }
+        })
+        return
+      }
+      conns.forEach(function (conn) {
+        conn.close(function () {
+          pending -= 1
+          if (pending === 0 && callback) {
+            callback(null)
+          }
+        })
+      })
+    }
+
+    function on (event, listener) {
+      emitter.on(event, listener)
+    }
+
+    function removeListener (event, listener) {
+      emitter.removeListener(event, listener)
+    }
+
+    var publicApi = {
+      open: open,
+      acquire: acquire,
+      release: release,
+      use: use,
+      close: close,
+      getMetrics: getMetrics,
+      on: on,
+      removeListener: removeListener
+    }
+
+    return publicApi
+  }
+
+  return {
+    Pool: Pool
+  }
+}())
+
+exports.poolModule = poolModule
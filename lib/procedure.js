@@ -317,10 +317,13 @@ var procedureModule = (function () {
       })
     }
 
-    function callproc (name, paramsOrCb, cb) {
+    // options.signal, an AbortSignal, cancels the call when aborted.
+
+    function callproc (name, paramsOrCb, cb, options) {
       var notify = new notifier.StreamEvents()
       createProcedure(name, function (p) {
         p.callNotify(paramsOrCb, cb, notify)
+        notifier.abortOn(notify, options && options.signal)
       })
       return notify
     }
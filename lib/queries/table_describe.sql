@@ -37,6 +37,7 @@ SELECT
   c.is_computed,
   c.is_identity,
   c.object_id,
+  c.column_id,
   (
   CASE
   WHEN CONSTRAINT_NAME IN (SELECT NAME
@@ -5,7 +5,9 @@
 'use strict'
 
 var queueModule = (function () {
-  function WorkQueue () {
+  // onEmpty, if given, is called each time the last queued operation completes.
+
+  function WorkQueue (onEmpty) {
     var workQueue = []
 
     function emptyQueue () {
@@ -47,6 +49,8 @@ var queueModule = (function () {
       if (workQueue.length !== 0) {
         var op = workQueue[0]
         op.fn.apply(op.fn, op.args)
+      } else if (onEmpty) {
+        onEmpty()
       }
     }
 
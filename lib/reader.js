@@ -7,6 +7,13 @@
 'use strict'
 
 var readerModule = (function () {
+  // a date read as utc shown as the same wall clock time in the local zone, for a
+  // connection with useUTC false.
+
+  function localDate (data) {
+    return new Date(data.getTime() - data.getTimezoneOffset() * -60000)
+  }
+
   function DriverRead (cppDriver, queue) {
     var native = cppDriver
     var workQueue = queue
@@ -38,14 +45,38 @@ var readerModule = (function () {
       var rowIndex = 0
       var outputParams = []
       var partialCol
+      var fetching
 
       var queryId = notify.getQueryId()
+      var queue = invokeObject.queue || workQueue
+
+      // the next native read is issued as soon as the previous one completes, ahead of the hop
+      // in which its result is marshalled, so the driver worker fetches while JS builds rows.
+      // a statement's completions arrive in the order its reads were issued and immediates run
+      // in order, so results are still delivered in sequence. fetching is the column read
+      // natively, column the one being delivered.
+
+      function readAhead (more) {
+        if (more) {
+          native.readColumn(queryId, fetching, onReadColumnMore)
+          return
+        }
+        fetching += 1
+        if (fetching >= meta.length) {
+          native.readRow(queryId, onReadRow)
+        } else {
+          native.readColumn(queryId, fetching, onReadColumn)
+        }
+      }
 
       function onReadColumnMore (err, results) {
+        if (!err) {
+          readAhead(results.more)
+        }
         setImmediate(function queuedOnReadColumnMore () {
           if (err) {
             routeStatementError(err, callback, notify, false)
-            workQueue.nextOp()
+            queue.nextOp()
             return
           }
 
@@ -69,27 +100,21 @@ var readerModule = (function () {
             rows[rows.length - 1][column] = partialCol
           }
 
-          if (more) {
-            native.readColumn(queryId, column, onReadColumnMore)
-            return
-          }
-
-          column += 1
-          partialCol = null
-          if (column >= meta.length) {
-            native.readRow(queryId, onReadRow)
-            return
+          if (!more) {
+            column += 1
+            partialCol = null
           }
-
-          native.readColumn(queryId, column, onReadColumn)
         })
       }
 
       function onReadColumn (err, results) {
+        if (!err) {
+          readAhead(results.more)
+        }
         setImmediate(function queuedOnReadColumn () {
           if (err) {
             routeStatementError(err, callback, notify, false)
-            workQueue.nextOp()
+            queue.nextOp()
             return
           }
 
@@ -98,7 +123,7 @@ var readerModule = (function () {
 
           if (data && useUTC === false) {
             if (meta[column].type === 'date') {
-              data = new Date(data.getTime() - data.getTimezoneOffset() * -60000)
+              data = localDate(data)
             }
           } else if (data) {
             partialCol = data
@@ -114,27 +139,27 @@ var readerModule = (function () {
             rows[rows.length - 1][column] = data
           }
 
-          if (more) {
-            native.readColumn(queryId, column, onReadColumnMore)
-            return
-          }
-
-          column += 1
-
-          if (column >= meta.length) {
-            native.readRow(queryId, onReadRow)
-            return
+          if (!more) {
+            column += 1
           }
-          native.readColumn(queryId, column, onReadColumn)
         })
       }
 
-      function rowsCompleted (results, more) {
+      // the last result read may already have freed the statement and fetched the output
+      // parameters, as asked by invokeObject.finish, so end has no further call to make.
+
+      function rowsCompleted (results, more, nextResultSetInfo) {
+        var finished = !more && nextResultSetInfo && nextResultSetInfo.freed !== undefined
+          ? nextResultSetInfo
+          : null
+        if (finished && finished.outputParams) {
+          outputParams = finished.outputParams
+        }
         if (!more) {
           notify.emit('done')
         }
 
-        invokeObject.end(queryId, outputParams, callback, results, more)
+        invokeObject.end(queryId, outputParams, callback, results, more, finished)
       }
 
       function rowsAffected (nextResultSetInfo) {
@@ -148,21 +173,29 @@ var readerModule = (function () {
           rowcount: rowCount
         }
 
-        rowsCompleted(state, moreResults)
+        rowsCompleted(state, moreResults, nextResultSetInfo)
       }
 
+      // once the last result read has freed the statement the native side is done with this
+      // query, so the next queued operation starts while these results are delivered. its own
+      // completions cannot arrive before the immediate below has run.
+
       function onNextResult (err, nextResultSetInfo, more) {
+        var released = !err && nextResultSetInfo.endOfResults && nextResultSetInfo.freed !== undefined
+        if (released) {
+          queue.nextOp()
+        }
         setImmediate(function queuedOnNextResult () {
           if (err) {
             routeStatementError(err, callback, notify, more)
             if (!more) {
-              workQueue.nextOp()
+              queue.nextOp()
               return
             }
           }
 
           if (!meta && !more) {
-            rowsCompleted({meta: meta, rows: rows}, !nextResultSetInfo.endOfResults)
+            rowsCompleted({meta: meta, rows: rows}, !nextResultSetInfo.endOfResults, nextResultSetInfo)
           } else if (meta && !err && meta.length === 0) {
             // handle the just finished result reading
             // if there was no metadata, then pass the row count (rows affected)
@@ -171,20 +204,22 @@ var readerModule = (function () {
             var completed = more && rows && rows.length === 0
             // if more is true, no error set or results do not call back.
             if (!completed) {
-              rowsCompleted({meta: meta, rows: rows}, !nextResultSetInfo.endOfResults)
+              rowsCompleted({meta: meta, rows: rows}, !nextResultSetInfo.endOfResults, nextResultSetInfo)
             }
           }
 
           // reset for the next resultset
           meta = nextResultSetInfo.meta
           if (!meta) {
-            native.nextResult(queryId, onNextResult)
+            native.nextResult(queryId, onNextResult, invokeObject.finish)
             return
           }
           rows = []
           if (nextResultSetInfo.endOfResults) {
             // What about closed connections due to more being false in the callback?  See queryRaw below.
-            workQueue.nextOp()
+            if (!released) {
+              queue.nextOp()
+            }
           } else {
             // if this is just a set of rows
             if (meta.length > 0) {
@@ -192,18 +227,26 @@ var readerModule = (function () {
               // kick off reading next set of rows
               native.readRow(queryId, onReadRow)
             } else {
-              native.nextResult(queryId, onNextResult)
+              native.nextResult(queryId, onNextResult, invokeObject.finish)
             }
           }
         })
       }
 
       function onReadRow (err, endOfRows) {
+        var row = !err && meta.length > 0 && !endOfRows
+        if (row) {
+          fetching = 0
+          native.readColumn(queryId, fetching, onReadColumn)
+        } else if (!err) {
+          // otherwise, go to the next result set
+          native.nextResult(queryId, onNextResult, invokeObject.finish)
+        }
         setImmediate(function queuedOnReadRow () {
           if (err) {
             routeStatementError(err, callback, notify, false)
-            workQueue.nextOp()
-          } else if (meta.length > 0 && !endOfRows) {
+            queue.nextOp()
+          } else if (row) {
             // if there were rows and we haven't reached the end yet (like EOF)
             notify.emit('row', rowIndex)
             rowIndex += 1
@@ -211,10 +254,6 @@ var readerModule = (function () {
             if (callback) {
               rows[rows.length] = []
             }
-            native.readColumn(queryId, column, onReadColumn)
-          } else {
-            // otherwise, go to the next result set
-            native.nextResult(queryId, onNextResult)
           }
         })
       }
@@ -228,7 +267,7 @@ var readerModule = (function () {
             invokeObject.end(queryId, outputParams, function () {
               routeStatementError(err, callback, notify, false)
             }, null, more)
-            workQueue.nextOp()
+            queue.nextOp()
             return
           }
           routeStatementError(err, callback, notify, true)
@@ -239,7 +278,7 @@ var readerModule = (function () {
           notify.emit('meta', meta)
           native.readRow(queryId, onReadRow)
         } else {
-          native.nextResult(queryId, onNextResult)
+          native.nextResult(queryId, onNextResult, invokeObject.finish)
         }
       }
 
@@ -254,7 +293,8 @@ var readerModule = (function () {
   }
 
   return {
-    DriverRead: DriverRead
+    DriverRead: DriverRead,
+    localDate: localDate
   }
 }())
 
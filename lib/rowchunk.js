@@ -0,0 +1,147 @@
+// pull rows a chunk at a time from an object mode Readable, an async iterator or an
+// iterable such as an array. Only the current chunk, and one row read ahead to know
+// when the source has ended, is held at any time.
+
+'use strict'
+
+var rowChunkModule = (function () {
+  function RowChunker (source, chunkSize) {
+    var size = chunkSize > 0 ? chunkSize : 1000
+    var ahead = []
+    var pull = puller(source)
+
+    function readableSource (readable) {
+      var waiting = null
+      var ended = false
+      var failed = null
+
+      function wake () {
+        if (waiting) {
+          var w = waiting
+          waiting = null
+          w()
+        }
+      }
+
+      readable.on('readable', wake)
+      readable.on('end', function () {
+        ended = true
+        wake()
+      })
+      readable.on('error', function (err) {
+        failed = err
+        wake()
+      })
+
+      return function (cb) {
+        function attempt () {
+          if (failed) {
+            cb(failed)
+            return
+          }
+          var row = readable.read()
+          if (row !== null) {
+            cb(null, row, false)
+          } else if (ended) {
+            cb(null, null, true)
+          } else {
+            waiting = attempt
+          }
+        }
+        attempt()
+      }
+    }
+
+    function iteratorSource (it) {
+      return function (cb) {
+        var res
+        try {
+          res = it.next()
+        } catch (err) {
+          cb(err)
+          return
+        }
+        if (res && typeof res.then === 'function') {
+          res.then(function (r) {
+            cb(null, r.value, r.done)
+          }, function (err) {
+            cb(err)
+          })
+        } else {
+          cb(null, res.value, res.done)
+        }
+      }
+    }
+
+    function puller (src) {
+      if (src && typeof src.read === 'function' && typeof src.on === 'function') {
+        return readableSource(src)
+      }
+      if (typeof Symbol !== 'undefined') {
+        if (Symbol.asyncIterator && src && typeof src[Symbol.asyncIterator] === 'function') {
+          return iteratorSource(src[Symbol.asyncIterator]())
+        }
+        if (src && typeof src[Symbol.iterator] === 'function') {
+          return iteratorSource(src[Symbol.iterator]())
+        }
+      }
+      if (src && typeof src.next === 'function') {
+        return iteratorSource(src)
+      }
+      throw new Error('[msnodesql] row source must be a Readable, an iterator or an iterable')
+    }
+
+    // callback (err, rows, done) where done means no rows follow this chunk.
+    // rows available synchronously are gathered in a loop rather than by recursion.
+
+    function next (callback) {
+      var rows = ahead
+      var inLoop = false
+      var again = false
+      ahead = []
+
+      function onRow (err, row, end) {
+        if (err) {
+          callback(err, [], true)
+          return
+        }
+        if (end) {
+          callback(null, rows, true)
+          return
+        }
+        if (rows.length < size) {
+          rows.push(row)
+          if (inLoop) {
+            again = true
+          } else {
+            loop()
+          }
+          return
+        }
+        ahead.push(row)
+        callback(null, rows, false)
+      }
+
+      function loop () {
+        inLoop = true
+        do {
+          again = false
+          pull(onRow)
+        } while (again)
+        inLoop = false
+      }
+
+      loop()
+    }
+
+    return {
+      next: next
+    }
+  }
+
+  return {
+    RowChunker: RowChunker
+  }
+}())
+
+exports.rowChunkModule = rowChunkModule
@@ -27,6 +27,11 @@ exports.module = module
 exports.query = cw.query
 exports.queryRaw = cw.queryRaw
 exports.open = cw.open
+exports.Pool = cw.Pool
+exports.setWorkerThreads = cw.setWorkerThreads
+exports.getWorkerThreads = cw.getWorkerThreads
+exports.setSchedulerClasses = cw.setSchedulerClasses
+exports.getSchedulerStats = cw.getSchedulerStats
 
 exports.Bit = us.Bit
 
@@ -73,3 +78,6 @@ exports.TzOffsetQuery = us.TzOffsetQuery
 
 exports.Table = us.Table
 exports.TvpFromTable = us.TvpFromTable
+exports.TvpFromStream = us.TvpFromStream
+exports.RowLayout = us.RowLayout
+exports.PackedRows = us.PackedRows
@@ -13,13 +13,19 @@
 
 'use strict'
 
+var stream = require('stream')
+var events = require('events')
+var fs = require('fs')
+
 var tableModule = (function () {
-  function TableMgr (connection, connectionMeta, connectionUser) {
+  function TableMgr (connection, connectionMeta, connectionUser, connectionDriver) {
     var cache = {}
     var bulkTableManagers = {}
     var theConnection = connection
     var metaResolver = connectionMeta
     var user = connectionUser
+    var driverMgr = connectionDriver
+    var stageTableId = 0
 
     function describeTable (tableName, callback) {
       var cat
@@ -265,6 +271,7 @@ var tableModule = (function () {
           columns: allColumns,
           primaryColumns: primaryCols,
           assignableColumns: assignableColumns,
+          fullTableName: fullTableName,
           by_name: colByName
         }
       }
@@ -355,6 +362,15 @@ var tableModule = (function () {
     function BulkTableOpMgr (m) {
       var meta = m
       var batch = 0
+      var parallel = null
+      var joinThreshold = 1000
+      var selectJoinThreshold = 100
+      var tuner = null
+      var emitter = new events.EventEmitter()
+      var batchStats = {
+        rowsPerSecond: 0,
+        latencyMs: 0
+      }
       var summary = meta.getSummary()
 
       function asTableType (name) {
@@ -368,27 +384,57 @@ var tableModule = (function () {
         return new user.Table(name, cols)
       }
 
+      // the sql declaration of a column type, with the length, precision or scale it was defined with.
+
+      function declarationForCol (col) {
+        var declaration = col.type
+        switch (col.type) {
+          case 'nvarchar':
+          case 'nchar':
+            declaration += col.max_length > 0 ? '(' + col.max_length / 2 + ')' : '(max)'
+            break
+
+          case 'varchar':
+          case 'char':
+          case 'varbinary':
+          case 'binary':
+            declaration += col.max_length > 0 ? '(' + col.max_length + ')' : '(max)'
+            break
+
+          case 'decimal':
+          case 'numeric':
+            declaration += '(' + col.precision + ', ' + col.scale + ')'
+            break
+
+          case 'datetime2':
+          case 'time':
+          case 'datetimeoffset':
+            declaration += '(' + col.scale + ')'
+            break
+
+          default:
+            break
+        }
+        return declaration
+      }
+
       function userTypeCols () {
         var summary = meta.getSummary()
         var columns = summary.columns
         var cols = []
         columns.forEach(function (col) {
-          var declaration = col.name + ' ' + col.type
           var length = 0
           if (col.max_length > 0) {
-            if (col.type === 'nvarchar') {
+            if (col.type === 'nvarchar' || col.type === 'nchar') {
               length = col.max_length / 2
-            } else if (col.type === 'varbinary') {
+            } else if (col.type === 'varbinary' || col.type === 'varchar' || col.type === 'char' || col.type === 'binary') {
               length = col.max_length
             }
           }
 
-          if (length > 0) {
-            declaration += '(' + length + ')'
-          }
           cols.push({
             name: col.name,
-            userType: declaration,
+            userType: col.name + ' ' + declarationForCol(col),
             type: {
               declaration: col.type,
               length: length
@@ -417,86 +463,214 @@ var tableModule = (function () {
         return sql
       }
 
-      // create an object of arrays where each array represents all values
-      // for the batch.
+      // batches are cut from the input as they are sent, of the fixed batch size if one
+      // is set, of the size currently chosen by the tuner in adaptive mode, else all rows.
+
+      function batchSource (rows) {
+        var pos = 0
+        var index = 0
 
-      function prepare (vec, o, arrays) {
-        var keys = []
-        if (vec.length === 0) {
-          return keys
+        function size () {
+          if (tuner) {
+            return tuner.getSize()
+          }
+          return batch > 0 ? batch : rows.length
         }
-        summary.columns.forEach(function (col) {
-          var property = col.name
-          // noinspection JSUnresolvedVariable
-          if (summary.by_name.hasOwnProperty(property) &&
-            summary.by_name[property].is_computed === false) {
-            keys.push(property)
-            var arr = o[property]
-            if (!arr) {
-              arr = []
-              o[property] = arr
-              arrays.push(arr)
-            }
+
+        function next () {
+          var requested = size()
+          var b = {
+            index: index,
+            requested: requested,
+            rows: rows.slice(pos, pos + requested),
+            start: Date.now()
           }
-        })
-        return keys
+          pos += b.rows.length
+          index += 1
+          return b
+        }
+
+        function remaining () {
+          return rows.length - pos
+        }
+
+        function complete (b, err) {
+          if (b.rows.length === 0) {
+            return
+          }
+          var elapsed = Math.max(1, Date.now() - b.start)
+          batchStats = {
+            rowsPerSecond: Math.round(b.rows.length * 1000 / elapsed),
+            latencyMs: elapsed
+          }
+          if (tuner && (err || b.rows.length === b.requested)) {
+            tuner.observe(b.rows.length, elapsed, err)
+          }
+        }
+
+        return {
+          next: next,
+          remaining: remaining,
+          complete: complete
+        }
+      }
+
+      function now () {
+        var t = process.hrtime()
+        return t[0] * 1e3 + t[1] / 1e6
       }
 
-      function arrayPerColumn (vec) {
-        var arrayColumnByName = {}
-        var arrayOfArrays = []
-        var keys = prepare(vec, arrayColumnByName, arrayOfArrays)
+      function nativeTimings (conn) {
+        return typeof conn.nativeTimings === 'function' ? conn.nativeTimings() : null
+      }
+
+      // an operation sent a batch at a time. a 'progress' event follows each batch and a
+      // 'summary' event the last one, giving batches and rows completed, those that failed
+      // counted apart as failedBatches and failedRows, bytes bound, and the ms spent preparing
+      // the column arrays in js, binding them natively (where row objects are transposed) and
+      // executing the statement on the background thread.
+      // bound bytes, bind and execute ms come from the difference in the connection's native
+      // totals across the batch, so they are approximate: they also count any other statement
+      // completing on that connection meanwhile, such as the caller's own queries or others
+      // running alongside it with multiple active result sets.
+
+      function BatchJob (operation, sql, rows, columnArrays) {
+        var started = now()
+        var totals = {
+          operation: operation,
+          batches: 0,
+          rows: 0,
+          failedBatches: 0,
+          failedRows: 0,
+          totalRows: rows.length,
+          boundBytes: 0,
+          prepareMs: 0,
+          bindMs: 0,
+          executeMs: 0,
+          elapsedMs: 0,
+          rowsPerSecond: 0
+        }
 
-        vec.forEach(function (instance) {
-          keys.forEach(function (property) {
-            var columnValues = arrayColumnByName[property]
-            var val = instance.hasOwnProperty(property)
-              ? instance[property]
-              : null
-            columnValues.push(val)
+        function snapshot () {
+          var copy = {}
+          Object.keys(totals).forEach(function (k) {
+            copy[k] = totals[k]
           })
-        })
+          return copy
+        }
+
+        function send (b, conn, done) {
+          var t = now()
+          var params = columnArrays(b.rows)
+          b.prepareMs = now() - t
+          b.conn = conn
+          b.native = nativeTimings(conn)
+          conn.query(sql, params, done)
+        }
+
+        function complete (b, err) {
+          var native = nativeTimings(b.conn)
+          if (err) {
+            totals.failedBatches += 1
+            totals.failedRows += b.rows.length
+          } else {
+            totals.batches += 1
+            totals.rows += b.rows.length
+          }
+          totals.prepareMs += b.prepareMs
+          if (native && b.native) {
+            totals.bindMs += (native.bindMicros - b.native.bindMicros) / 1e3
+            totals.executeMs += (native.executeMicros - b.native.executeMicros) / 1e3
+            totals.boundBytes += native.boundBytes - b.native.boundBytes
+          }
+          totals.elapsedMs = now() - started
+          totals.rowsPerSecond = Math.round(totals.rows * 1e3 / Math.max(1, totals.elapsedMs))
+          emitter.emit('progress', snapshot())
+        }
+
+        function finish (err) {
+          var s = snapshot()
+          s.error = err || null
+          emitter.emit('summary', s)
+        }
 
         return {
-          arrays_by_name: arrayColumnByName,
-          array_of_arrays: arrayOfArrays
+          rows: rows,
+          send: send,
+          complete: complete,
+          finish: finish
         }
       }
 
-      // if batch size is set, split the input into that batch size.
+      // estimated bytes a row occupies, unbounded columns counted as 1k. summary.columns
+      // repeats a column for each constraint it takes part in, so each is counted once.
 
-      function rowBatches (rows) {
-        var batches = []
-        if (batch === 0) {
-          batches.push(rows)
-        } else {
-          var singleBatch = []
-          var i
-          for (i = 0; i < rows.length; i += 1) {
-            singleBatch.push(rows[i])
-            if (singleBatch.length === batch) {
-              batches.push(singleBatch)
-              singleBatch = []
-            }
+      function rowWidth () {
+        var width = 0
+        uniqueColumns(summary.columns).forEach(function (col) {
+          width += col.max_length > 0 ? col.max_length : 1024
+        })
+        return Math.max(1, width)
+      }
+
+      // additive increase, multiplicative decrease. the size grows by a quarter of its
+      // starting value while batches finish within targetMs and throughput holds, and is
+      // halved when a batch is slow, fails or its throughput falls. the starting size is
+      // targetBytes of rows given the row width, so wide tables start with smaller batches.
+
+      function BatchTuner (options) {
+        var min = options.min > 0 ? options.min : 100
+        var max = options.max >= min ? options.max : Math.max(min, 50000)
+        var targetMs = options.targetMs > 0 ? options.targetMs : 500
+        var targetBytes = options.targetBytes > 0 ? options.targetBytes : 1024 * 1024
+        var size = clamp(Math.round(targetBytes / rowWidth()))
+        var step = Math.max(1, Math.round(size / 4))
+        var smoothedRate = 0
+
+        function clamp (n) {
+          return Math.min(max, Math.max(min, n))
+        }
+
+        function observe (rows, elapsed, err) {
+          var rate = rows * 1000 / elapsed
+          if (err || elapsed > targetMs || rate < smoothedRate * 0.75) {
+            size = clamp(Math.floor(size / 2))
+          } else {
+            size = clamp(size + step)
           }
+          smoothedRate = smoothedRate === 0 ? rate : smoothedRate * 0.7 + rate * 0.3
+        }
+
+        function getSize () {
+          return size
         }
 
-        return batches
+        return {
+          observe: observe,
+          getSize: getSize
+        }
       }
 
-      // driver will have to recognise this is an array of arrays where each array
-      // represents all values for that particular column.
+      // the driver transposes the row objects natively, each column typed as declared so its
+      // values are written straight into the bound buffers as the rows are walked.
 
       function arrayPerColumnForCols (rows, colSubSet) {
-        var colsByName = arrayPerColumn(rows).arrays_by_name
-        var colArray = []
-
+        if (rows.length === 0) {
+          return []
+        }
+        var cols = []
         colSubSet.forEach(function (col) {
-          if (colsByName.hasOwnProperty(col.name)) {
-            colArray.push(colsByName[col.name])
+          var property = col.name
+          // noinspection JSUnresolvedVariable
+          if (summary.by_name.hasOwnProperty(property) &&
+            summary.by_name[property].is_computed === false) {
+            cols.push({
+              key: property,
+              type: bulkType(summary.by_name[property], null)
+            })
           }
         })
-        return colArray
+        return [user.ColumnsFromRows(rows, cols)]
       }
 
       // given the input array of asObjects consisting of potentially all columns, strip out
@@ -507,7 +681,14 @@ var tableModule = (function () {
         theConnection.query(sql, colArray, callback)
       }
 
+      // from selectJoinThreshold keys the keys are staged and joined; fewer are looked up with
+      // the parameterised select, one round trip rather than the four staging takes.
+
       function selectRows (rows, callback) {
+        if (selectJoinThreshold > 0 && rows.length >= selectJoinThreshold && rows.length > 1) {
+          selectRowsByKeys(rows, callback)
+          return
+        }
         var res = []
         whereForRowsNoBatch(summary.selectSignature, rows, function (err, results, more) {
           results.forEach(function (r) {
@@ -519,64 +700,623 @@ var tableModule = (function () {
         })
       }
 
+      function createStageSql (stageTable, cols) {
+        return 'create table ' + stageTable + ' (' + cols.map(function (col) {
+          var declaration = declarationForCol(col)
+          if (col.type.indexOf('char') >= 0 || col.type.indexOf('text') >= 0) {
+            declaration += ' collate database_default'
+          }
+          return '[' + col.name + '] ' + declaration
+        }).join(', ') + ')'
+      }
+
+      // bulk copy rows into a temp table holding the given columns, run work against it,
+      // then drop it. work is called (stageTable, done) and done (err, res) is passed on.
+
+      function stageRows (cols, rowsOrColumns, work, callback) {
+        var stageTable = '#msnodesql_stage_' + (stageTableId += 1)
+        var create = createStageSql(stageTable, cols)
+
+        function drop (err, res) {
+          theConnection.query('drop table ' + stageTable, function (dropErr) {
+            callback(err || dropErr, res)
+          })
+        }
+
+        theConnection.query(create, function (err) {
+          if (err) {
+            callback(err)
+            return
+          }
+          bulkCopyColumns(stageTable, cols.map(function (col, i) {
+            return {
+              col: col,
+              ordinal: i + 1
+            }
+          }), rowsOrColumns, {}, function (err) {
+            if (err) {
+              drop(err)
+              return
+            }
+            work(stageTable, drop)
+          })
+        })
+      }
+
+      function uniqueColumns (cols) {
+        var seen = {}
+        return cols.filter(function (col) {
+          var first = !seen.hasOwnProperty(col.name)
+          seen[col.name] = true
+          return first
+        })
+      }
+
+      function joinOn (cols) {
+        return cols.map(function (col) {
+          return 't.[' + col.name + '] = s.[' + col.name + ']'
+        }).join(' and ')
+      }
+
+      // rather than one select executed per key, bulk copy the keys into a temp table
+      // and join it to the table once, returning a single result set in key order.
+
+      function selectRowsByKeys (rows, callback) {
+        var whereCols = summary.whereColumns
+        var ordinal = {
+          name: '__ordinal',
+          type: 'int'
+        }
+
+        var keys = {}
+        whereCols.forEach(function (col) {
+          keys[col.name] = rows.map(function (row) {
+            var v = row[col.name]
+            return v === undefined ? null : v
+          })
+        })
+        keys[ordinal.name] = rows.map(function (row, i) {
+          return i
+        })
+
+        function select (stageTable, done) {
+          var res = []
+          var sql = 'select ' + uniqueColumns(summary.columns).map(function (col) {
+            return 't.[' + col.name + ']'
+          }).join(', ') +
+            ' from ' + summary.fullTableName + ' t inner join ' + stageTable + ' s on ' +
+            joinOn(whereCols) + ' order by s.[__ordinal]'
+
+          theConnection.query(sql, function (err, results, more) {
+            if (results) {
+              results.forEach(function (r) {
+                res.push(r)
+              })
+            }
+            if (err || !more) {
+              done(err, res)
+            }
+          })
+        }
+
+        stageRows(whereCols.concat([ordinal]), keys, select, function (err, res) {
+          callback(err, res || [])
+        })
+      }
+
       // for a bulk select, do not use batching.
 
       // delete using a batch at a time.
 
-      function batchIterator (rows, iterate, callback) {
-        var batches = rowBatches(rows)
-        var batchIndex = 0
+      function batchIterator (job, callback) {
+        if (parallel) {
+          parallelIterator(job, callback)
+          return
+        }
+        var source = batchSource(job.rows)
+        var current = source.next()
+        var batchErr = null
 
         function done (err, results, more) {
-          batchIndex += 1
-          if (!err && batchIndex < batches.length) {
+          batchErr = batchErr || err
+          if (!more) {
+            source.complete(current, err)
+            job.complete(current, batchErr)
+            batchErr = null
+          }
+          if (!err && source.remaining() > 0) {
             if (!more) {
-              iterate(batches[batchIndex], done)
+              current = source.next()
+              job.send(current, theConnection, done)
             }
           } else {
+            if (!more) {
+              job.finish(err)
+            }
             callback(err, results, more)
           }
         }
 
-        iterate(batches[batchIndex], done)
+        job.send(current, theConnection, done)
+      }
+
+      // batches are spread over the parallel connections, at most degree running at once,
+      // each connection running one batch at a time. every batch is attempted; failures are
+      // reported on the first error as batchErrors [{batch, error}] in batch order.
+
+      function parallelIterator (job, callback) {
+        var source = batchSource(job.rows)
+        var free = parallel.connections.slice(0, parallel.degree)
+        var running = 0
+        var batchErrors = []
+
+        function finish () {
+          var err = null
+          if (batchErrors.length > 0) {
+            batchErrors.sort(function (a, b) {
+              return a.batch - b.batch
+            })
+            err = batchErrors[0].error
+            err.batchErrors = batchErrors
+          }
+          job.finish(err)
+          callback(err, [], false)
+        }
+
+        function launch () {
+          while (free.length > 0 && source.remaining() > 0) {
+            run(free.shift(), source.next())
+          }
+        }
+
+        // a statement error may arrive with more results to follow, so the first error is
+        // kept until the batch completes.
+
+        function run (conn, b) {
+          var batchErr = null
+          running += 1
+          job.send(b, conn, function (err, results, more) {
+            if (err && !batchErr) {
+              batchErr = err
+            }
+            if (more) {
+              return
+            }
+            running -= 1
+            free.push(conn)
+            source.complete(b, batchErr)
+            job.complete(b, batchErr)
+            if (batchErr) {
+              batchErrors.push({
+                batch: b.index,
+                error: batchErr
+              })
+            }
+            if (source.remaining() > 0) {
+              launch()
+            } else if (running === 0) {
+              finish()
+            }
+          })
+        }
+
+        if (source.remaining() === 0) {
+          setImmediate(finish)
+          return
+        }
+        launch()
       }
 
       function whereForRows (sql, rows, callback) {
-        function next (batch, done) {
-          var colArray = arrayPerColumnForCols(batch, summary.whereColumns)
-          theConnection.query(sql, colArray, done)
+        function columnArrays (batch) {
+          return arrayPerColumnForCols(batch, summary.whereColumns)
         }
 
-        batchIterator(rows, next, callback)
+        batchIterator(new BatchJob('delete', sql, rows, columnArrays), callback)
       }
 
       function updateForRows (sql, rows, callback) {
-        function next (batch, done) {
+        function columnArrays (batch) {
           var updateArray = arrayPerColumnForCols(batch, summary.updateColumns)
           var whereArray = arrayPerColumnForCols(batch, summary.whereColumns)
-          var colArray = updateArray.concat(whereArray)
-          theConnection.query(sql, colArray, done)
+          return updateArray.concat(whereArray)
         }
 
-        batchIterator(rows, next, callback)
+        batchIterator(new BatchJob('update', sql, rows, columnArrays), callback)
       }
 
       function insertRows (rows, callback) {
-        function next (batch, done) {
-          var sql = summary.insertSignature
-          var colArray = arrayPerColumnForCols(batch, summary.assignableColumns)
-          theConnection.query(sql, colArray, done)
+        function columnArrays (batch) {
+          return arrayPerColumnForCols(batch, summary.assignableColumns)
         }
 
-        batchIterator(rows, next, callback)
+        if (parallel && parallel.staged) {
+          stagedInsertRows(rows, columnArrays, callback)
+          return
+        }
+        batchIterator(new BatchJob('insert', summary.insertSignature, rows, columnArrays), callback)
+      }
+
+      // one logical load spread over the parallel connections: the batches are inserted into a
+      // global temp table, visible to every connection, and only once all of them succeed are
+      // the rows moved to the table in a single statement on this connection. should any batch
+      // fail nothing is loaded, the error carrying batchErrors as in parallelIterator.
+
+      function stagedInsertRows (rows, columnArrays, callback) {
+        var cols = summary.assignableColumns
+        var names = cols.map(function (col) {
+          return '[' + col.name + ']'
+        }).join(', ')
+        var stageTable = '##msnodesql_load_' + process.pid + '_' + (stageTableId += 1) + '_' +
+          Math.random().toString(36).slice(2, 10)
+        var stageInsert = 'insert into ' + stageTable + ' (' + names + ') values (' + cols.map(function () {
+          return '?'
+        }).join(', ') + ')'
+        var job = new BatchJob('insert', stageInsert, rows, columnArrays)
+        var stagingJob = {
+          rows: job.rows,
+          send: job.send,
+          complete: job.complete,
+          finish: function () {}
+        }
+
+        function drop (err) {
+          theConnection.query('drop table ' + stageTable, function (dropErr) {
+            err = err || dropErr
+            job.finish(err)
+            callback(err, [], false)
+          })
+        }
+
+        function load (err) {
+          if (err) {
+            drop(err)
+            return
+          }
+          theConnection.query('insert into ' + summary.fullTableName + ' (' + names + ') select ' + names +
+            ' from ' + stageTable, drop)
+        }
+
+        theConnection.query(createStageSql(stageTable, cols), function (err) {
+          if (err) {
+            job.finish(err)
+            callback(err, [], false)
+            return
+          }
+          parallelIterator(stagingJob, load)
+        })
+      }
+
+      // insert or update each row with a single merge from a bulk copied staging table,
+      // matched on the where columns. callback (err, {inserted, updated}).
+
+      function upsertRows (rows, callback) {
+        var counts = {
+          inserted: 0,
+          updated: 0
+        }
+        if (rows.length === 0) {
+          setImmediate(function () {
+            callback(null, counts)
+          })
+          return
+        }
+        var whereCols = summary.whereColumns
+        var insertCols = summary.assignableColumns
+        var updateCols = summary.updateColumns
+        var stageCols = uniqueColumns(whereCols.concat(insertCols))
+
+        function merge (stageTable, done) {
+          var sql = 'declare @actions table (action nvarchar(10)); ' +
+            'merge into ' + summary.fullTableName + ' with (holdlock) as t using ' + stageTable + ' as s' +
+            ' on (' + joinOn(whereCols) + ')'
+          if (updateCols.length > 0) {
+            sql += ' when matched then update set ' + updateCols.map(function (col) {
+              return 't.[' + col.name + '] = s.[' + col.name + ']'
+            }).join(', ')
+          }
+          sql += ' when not matched then insert (' + insertCols.map(function (col) {
+            return '[' + col.name + ']'
+          }).join(', ') + ') values (' + insertCols.map(function (col) {
+            return 's.[' + col.name + ']'
+          }).join(', ') + ')' +
+            ' output $action into @actions; ' +
+            'select action, count(*) as count from @actions group by action'
+
+          theConnection.query(sql, function (err, results, more) {
+            if (results) {
+              results.forEach(function (r) {
+                if (r.action === 'INSERT') {
+                  counts.inserted = r.count
+                } else if (r.action === 'UPDATE') {
+                  counts.updated = r.count
+                }
+              })
+            }
+            if (err || !more) {
+              done(err, counts)
+            }
+          })
+        }
+
+        stageRows(stageCols, rows, merge, callback)
+      }
+
+      // from joinThreshold rows, rather than the statement executed once per row, the rows
+      // are bulk copied to a staging table and applied with a single join on the where columns.
+
+      function useJoin (rows) {
+        return joinThreshold > 0 && rows.length >= joinThreshold && summary.whereColumns.length > 0
+      }
+
+      function joinForRows (operation, sql, stageCols, rows, callback) {
+        var job = new BatchJob(operation, sql, rows, null)
+        var staged = {
+          rows: rows,
+          prepareMs: 0,
+          conn: theConnection,
+          native: nativeTimings(theConnection)
+        }
+
+        function apply (stageTable, done) {
+          theConnection.query(sql + ' ' + stageTable + ' s on ' + joinOn(summary.whereColumns), function (err, results, more) {
+            if (err || !more) {
+              done(err, [])
+            }
+          })
+        }
+
+        stageRows(stageCols, rows, apply, function (err, res) {
+          job.complete(staged, err)
+          job.finish(err)
+          callback(err, res || [], false)
+        })
       }
 
       function updateRows (rows, callback) {
-        updateForRows(summary.updateSignature, rows, callback)
+        if (!useJoin(rows) || summary.updateColumns.length === 0) {
+          updateForRows(summary.updateSignature, rows, callback)
+          return
+        }
+        var sql = 'update t set ' + summary.updateColumns.map(function (col) {
+          return 't.[' + col.name + '] = s.[' + col.name + ']'
+        }).join(', ') + ' from ' + summary.fullTableName + ' t inner join'
+        joinForRows('update', sql, uniqueColumns(summary.whereColumns.concat(summary.updateColumns)), rows, callback)
       }
 
       function deleteRows (rows, callback) {
-        whereForRows(summary.deleteSignature, rows, callback)
+        if (!useJoin(rows)) {
+          whereForRows(summary.deleteSignature, rows, callback)
+          return
+        }
+        var sql = 'delete t from ' + summary.fullTableName + ' t inner join'
+        joinForRows('delete', sql, uniqueColumns(summary.whereColumns), rows, callback)
+      }
+
+      // columns sent by bulk copy with their server ordinal. computed columns are
+      // never sent, identity columns only when their values are kept.
+
+      function bulkColumns (keepIdentity) {
+        var ids = []
+        summary.columns.forEach(function (col) {
+          if (ids.indexOf(col.column_id) < 0) {
+            ids.push(col.column_id)
+          }
+        })
+        ids.sort(function (a, b) {
+          return a - b
+        })
+        var cols = []
+        Object.keys(summary.by_name).forEach(function (name) {
+          var col = summary.by_name[name]
+          if (col.is_computed === false && (keepIdentity || col.is_identity === false)) {
+            cols.push({
+              col: col,
+              ordinal: ids.indexOf(col.column_id) + 1
+            })
+          }
+        })
+        cols.sort(function (a, b) {
+          return a.ordinal - b.ordinal
+        })
+        return cols
+      }
+
+      // the type a column is declared with, or null for one with no mapping, whose values
+      // are then bound as given.
+
+      function bulkType (col, values) {
+        return user.getSqlTypeFromDeclaredType({
+          declaration: col.type,
+          precision: col.precision,
+          scale: col.scale
+        }, values)
+      }
+
+      // rows of objects are transposed natively, an object of arrays keyed by column
+      // name is bound one array per column as given.
+
+      function bulkCopyColumns (tableName, cols, rowsOrColumns, options, callback) {
+        var params
+        if (Array.isArray(rowsOrColumns)) {
+          params = rowsOrColumns.length === 0 ? [] : [user.ColumnsFromRows(rowsOrColumns, cols.map(function (c) {
+            return {
+              key: c.col.name,
+              type: bulkType(c.col, null)
+            }
+          }))]
+        } else {
+          var count = 0
+          cols.forEach(function (c) {
+            var values = rowsOrColumns[c.col.name]
+            if (values && values.length > count) {
+              count = values.length
+            }
+          })
+          params = count === 0 ? [] : cols.map(function (c) {
+            var values = rowsOrColumns[c.col.name]
+            if (!values) {
+              values = []
+              while (values.length < count) {
+                values.push(null)
+              }
+            }
+            return bulkType(c.col, values) || values
+          })
+        }
+        var hints = []
+        if (options.tableLock) {
+          hints.push('TABLOCK')
+        }
+        if (options.checkConstraints) {
+          hints.push('CHECK_CONSTRAINTS')
+        }
+        var bcpObj = {
+          table_name: tableName,
+          hints: hints.join(','),
+          batch_size: options.batchSize > 0 ? options.batchSize : 0,
+          keep_identity: options.keepIdentity === true,
+          ordinals: cols.map(function (c) {
+            return c.ordinal
+          })
+        }
+        driverMgr.bulkCopy(bcpObj, params, callback)
+      }
+
+      function bulkCopy (rowsOrColumns, options, callback) {
+        var cols = bulkColumns(options.keepIdentity === true)
+        bulkCopyColumns(summary.fullTableName, cols, rowsOrColumns, options, callback)
+      }
+
+      // read the header line of a delimited file to map its fields by name.
+
+      // the fields of the first row, by the rules the driver reads the file with: a field
+      // opening with the quote runs to the matching quote, a doubled quote standing for one,
+      // and may span lines; anything between the closing quote and the delimiter is dropped.
+      // an unquoted field loses the carriage return ending its line.
+
+      function firstCsvRow (text, delimiter, quote) {
+        var fields = []
+        var i = 0
+        for (;;) {
+          var field = ''
+          if (text[i] === quote) {
+            i += 1
+            while (i < text.length) {
+              if (text[i] === quote) {
+                if (text[i + 1] === quote) {
+                  field += quote
+                  i += 2
+                  continue
+                }
+                i += 1
+                break
+              }
+              field += text[i]
+              i += 1
+            }
+            while (i < text.length && text[i] !== delimiter && text[i] !== '\n') {
+              i += 1
+            }
+          } else {
+            var j = i
+            while (j < text.length && text[j] !== delimiter && text[j] !== '\n') {
+              j += 1
+            }
+            field = text.substring(i, j)
+            if (text[j] !== delimiter) {
+              field = field.replace(/\r$/, '')
+            }
+            i = j
+          }
+          fields.push(field)
+          if (i >= text.length || text[i] === '\n') {
+            return fields
+          }
+          i += 1
+        }
+      }
+
+      function readHeader (path, delimiter, quote, callback) {
+        fs.open(path, 'r', function (err, fd) {
+          if (err) {
+            callback(err)
+            return
+          }
+          var buffer = Buffer.alloc(64 * 1024)
+          fs.read(fd, buffer, 0, buffer.length, 0, function (err, bytes) {
+            fs.close(fd, function () {
+              if (err) {
+                callback(err)
+                return
+              }
+              var text = buffer.toString('utf8', 0, bytes).replace(/^\uFEFF/, '')
+              callback(null, firstCsvRow(text, delimiter, quote))
+            })
+          })
+        })
+      }
+
+      // the file is scanned and sent by the driver; no row reaches javascript. fields map to
+      // columns by header name, or by position without a header. columnMap renames header
+      // fields to columns, or as an array names the column for each field (null skips it).
+
+      function importFile (path, options, callback) {
+        var delimiter = options.delimiter || ','
+        var quote = options.quote || '"'
+        var header = options.header !== false
+        var keepIdentity = options.keepIdentity === true
+        var ordinalByName = {}
+        var cols = bulkColumns(keepIdentity)
+        cols.forEach(function (c) {
+          ordinalByName[c.col.name] = c.ordinal
+        })
+
+        function ordinalsFor (names) {
+          return names.map(function (name) {
+            return name && ordinalByName.hasOwnProperty(name) ? ordinalByName[name] : 0
+          })
+        }
+
+        function send (ordinals) {
+          var hints = []
+          if (options.tableLock) {
+            hints.push('TABLOCK')
+          }
+          if (options.checkConstraints) {
+            hints.push('CHECK_CONSTRAINTS')
+          }
+          driverMgr.bulkCopy({
+            table_name: summary.fullTableName,
+            hints: hints.join(','),
+            batch_size: options.batchSize > 0 ? options.batchSize : 0,
+            keep_identity: keepIdentity,
+            ordinals: ordinals,
+            file_name: path,
+            delimiter: delimiter.charCodeAt(0),
+            quote: quote.charCodeAt(0),
+            header: header
+          }, [], callback)
+        }
+
+        var columnMap = options.columnMap
+        if (Array.isArray(columnMap)) {
+          send(ordinalsFor(columnMap))
+        } else if (header) {
+          readHeader(path, delimiter, quote, function (err, names) {
+            if (err) {
+              callback(err)
+              return
+            }
+            send(ordinalsFor(names.map(function (name) {
+              return columnMap && columnMap.hasOwnProperty(name) ? columnMap[name] : name
+            })))
+          })
+        } else {
+          send(cols.map(function (c) {
+            return c.ordinal
+          }))
+        }
       }
 
       function getMeta () {
@@ -585,6 +1325,45 @@ var tableModule = (function () {
 
       function setBatchSize (batchSize) {
         batch = batchSize
+        tuner = null
+      }
+
+      // tune the batch size as batches complete rather than use a fixed size. options
+      // min, max, targetMs (batch latency) and targetBytes (first batch). null stops tuning.
+
+      function setAdaptiveBatchSize (options) {
+        tuner = options ? new BatchTuner(options) : null
+      }
+
+      // row count from which updateRows and deleteRows apply rows with one join against a
+      // staging table. 0 always sends the statement per row.
+
+      function setJoinThreshold (rows) {
+        joinThreshold = rows > 0 ? rows : 0
+      }
+
+      // key count from which selectRows joins a staged key table. 0 always uses the
+      // parameterised select.
+
+      function setSelectJoinThreshold (keys) {
+        selectJoinThreshold = keys > 0 ? keys : 0
+      }
+
+      // run insert, update and delete batches over a set of open connections to the same
+      // database, at most degree (default all of them) at once. null reverts to this connection.
+      // with options.staged, insertRows is one load staged across the connections, all the
+      // rows or none reaching the table.
+
+      function setParallel (connections, degree, options) {
+        if (!connections || connections.length === 0) {
+          parallel = null
+          return
+        }
+        parallel = {
+          connections: connections,
+          degree: degree > 0 ? Math.min(degree, connections.length) : connections.length,
+          staged: !!(options && options.staged)
+        }
       }
 
       function setWhereCols (whereCols) {
@@ -597,20 +1376,46 @@ var tableModule = (function () {
         summary = meta.getSummary()
       }
 
+      // the meta summary with the batch size in use and the throughput of the last batch.
+
       function getSummary () {
-        return meta.getSummary()
+        var s = meta.getSummary()
+        s.batchSize = tuner ? tuner.getSize() : batch
+        s.adaptiveBatchSize = tuner !== null
+        s.rowsPerSecond = batchStats.rowsPerSecond
+        s.batchLatencyMs = batchStats.latencyMs
+        return s
+      }
+
+      // listen for 'progress' and 'summary' events from insertRows, updateRows and deleteRows.
+
+      function on (event, listener) {
+        emitter.on(event, listener)
+      }
+
+      function removeListener (event, listener) {
+        emitter.removeListener(event, listener)
       }
 
       // public api
 
       return {
+        on: on,
+        removeListener: removeListener,
         asTableType: asTableType,
         asUserType: asUserType,
         insertRows: insertRows,
         selectRows: selectRows,
         deleteRows: deleteRows,
         updateRows: updateRows,
+        upsertRows: upsertRows,
+        bulkCopy: bulkCopy,
+        importFile: importFile,
         setBatchSize: setBatchSize,
+        setAdaptiveBatchSize: setAdaptiveBatchSize,
+        setParallel: setParallel,
+        setJoinThreshold: setJoinThreshold,
+        setSelectJoinThreshold: setSelectJoinThreshold,
         setWhereCols: setWhereCols,
         setUpdateCols: setUpdateCols,
         getMeta: getMeta,
@@ -628,9 +1433,73 @@ var tableModule = (function () {
       })
     }
 
+    // an object mode Writable of row objects. rows are held until a batch is full, which
+    // is then transposed natively and inserted; the write completes, and so more rows are
+    // accepted, only once that insert has finished. the last partial batch is inserted on end.
+
+    function createInsertStream (table, options) {
+      options = options || {}
+      var batchSize = options.batchSize > 0 ? options.batchSize : 1000
+      var rows = []
+      var bulkMgr = null
+
+      function withMgr (cb) {
+        if (bulkMgr) {
+          cb(bulkMgr)
+        } else {
+          bind(table, function (mgr) {
+            bulkMgr = mgr
+            cb(bulkMgr)
+          })
+        }
+      }
+
+      function flush (callback) {
+        if (rows.length === 0) {
+          callback()
+          return
+        }
+        var batch = rows
+        rows = []
+        // the insert may report an error with more to follow, the stream is told only once.
+        var called = false
+        withMgr(function (mgr) {
+          mgr.insertRows(batch, function (err, res, more) {
+            if (called || (!err && more)) {
+              return
+            }
+            called = true
+            if (err) {
+              callback(err)
+            } else {
+              insertStream.emit('batch', batch.length)
+              callback()
+            }
+          })
+        })
+      }
+
+      var insertStream = new stream.Writable({
+        objectMode: true,
+        highWaterMark: batchSize,
+        write: function (row, encoding, callback) {
+          rows.push(row)
+          if (rows.length >= batchSize) {
+            flush(callback)
+          } else {
+            callback()
+          }
+        },
+        final: flush
+      })
+
+      return insertStream
+    }
+
     return {
       describe: describe,
-      bind: bind
+      bind: bind,
+      createInsertStream: createInsertStream
     }
   }
 
@@ -1,6 +1,8 @@
 'use strict'
 
 var userModule = (function () {
+  var rowChunkModule = require('./rowchunk').rowChunkModule
+
   /*
  sql.UDT(value)
  sql.Geography(value)
@@ -103,12 +105,24 @@ var userModule = (function () {
       }
     }
 
+    // BigInt values are sent as decimal strings, which the driver binds exactly
+
+    function exactDecimal (p) {
+      if (Array.isArray(p)) {
+        return p.map(exactDecimal)
+      }
+      return typeof p === 'bigint'
+        ? p.toString()
+        : p
+    }
+
     // sql.Numeric(value, [precision], [scale]) -- optional precision and scale definition
+    // value may be a number, a decimal string or a BigInt
 
     function Numeric (p, precision, scale) {
       return {
         sql_type: SQL_NUMERIC,
-        value: p,
+        value: exactDecimal(p),
         precision: precision > 0
           ? precision
           : 0,
@@ -123,7 +137,7 @@ var userModule = (function () {
     function Money (p) {
       return {
         sql_type: SQL_NUMERIC,
-        value: p,
+        value: exactDecimal(p),
         precision: 0,
         scale: 0
       }
@@ -300,18 +314,102 @@ var userModule = (function () {
       }
     }
 
-    function fromRow (rows, c) {
-      var v
-      if (rows.length === 1) {
-        v = rows[0][c]
-      } else {
-        var r
-        v = []
-        for (r = 0; r < rows.length; ++r) {
-          v[v.length] = rows[r][c]
+    // C types used to describe row packed buffers
+
+    var SQL_C_CHAR = SQL_CHAR
+    var SQL_C_NUMERIC = SQL_NUMERIC
+    var SQL_C_FLOAT = SQL_REAL
+    var SQL_C_DOUBLE = SQL_DOUBLE
+    var SQL_C_WCHAR = -8
+    var SQL_C_BINARY = -2
+    var SQL_C_BIT = SQL_BIT
+    var SQL_C_SSHORT = -15
+    var SQL_C_SLONG = -16
+    var SQL_C_SBIGINT = -25
+    var SQL_C_TYPE_TIMESTAMP = SQL_TYPE_TIMESTAMP
+
+    // size 0 means the slot is length * width bytes, where length is given on the column
+
+    var packedTypes = {
+      bit: {c_type: SQL_C_BIT, sql_type: SQL_BIT, size: 1, align: 1},
+      smallint: {c_type: SQL_C_SSHORT, sql_type: SQL_SMALLINT, size: 2, align: 2},
+      int: {c_type: SQL_C_SLONG, sql_type: SQL_INTEGER, size: 4, align: 4},
+      bigint: {c_type: SQL_C_SBIGINT, sql_type: SQL_BIGINT, size: 8, align: 8},
+      real: {c_type: SQL_C_FLOAT, sql_type: SQL_REAL, size: 4, align: 4},
+      float: {c_type: SQL_C_DOUBLE, sql_type: SQL_DOUBLE, size: 8, align: 8},
+      decimal: {c_type: SQL_C_NUMERIC, sql_type: SQL_NUMERIC, size: 19, align: 1, precision: 18},
+      datetime2: {c_type: SQL_C_TYPE_TIMESTAMP, sql_type: SQL_TYPE_TIMESTAMP, size: 16, align: 4, precision: 27, scale: 7},
+      varchar: {c_type: SQL_C_CHAR, sql_type: SQL_VARCHAR, size: 0, width: 1, align: 1},
+      nvarchar: {c_type: SQL_C_WCHAR, sql_type: SQL_WVARCHAR, size: 0, width: 2, align: 2},
+      varbinary: {c_type: SQL_C_BINARY, sql_type: SQL_VARBINARY, size: 0, width: 1, align: 1}
+    }
+
+    function alignTo (offset, boundary) {
+      return Math.ceil(offset / boundary) * boundary
+    }
+
+    // sql.RowLayout([{name: 'id', type: 'int'}, {name: 'code', type: 'varchar', length: 10}])
+    // describes a row as the driver will bind it - each value is followed by its SQLLEN length
+    // indicator, which the writer sets to the byte length of the value or -1 for null.
+
+    function RowLayout (cols) {
+      var indSize = process.arch === 'ia32' ? 4 : 8
+      var rowSize = 0
+      var columns = cols.map(function (c) {
+        var t = packedTypes[c.type]
+        if (!t) {
+          throw new Error('[msnodesql] RowLayout unsupported column type ' + c.type)
         }
+        var length = c.length > 0 ? c.length : 1
+        var size = t.size > 0 ? t.size : length * t.width
+        var offset = alignTo(rowSize, t.align)
+        var indOffset = alignTo(offset + size, indSize)
+        rowSize = indOffset + indSize
+        return {
+          name: c.name,
+          type: c.type,
+          c_type: t.c_type,
+          sql_type: t.sql_type,
+          precision: t.size > 0 ? (c.precision || t.precision || 0) : length,
+          scale: c.scale || t.scale || 0,
+          size: size,
+          offset: offset,
+          ind_offset: indOffset
+        }
+      })
+
+      return {
+        row_size: alignTo(rowSize, indSize),
+        ind_size: indSize,
+        columns: columns
+      }
+    }
+
+    // sql.PackedRows(buffer, layout, [rows]) -- every parameter of the statement is read in place from
+    // rows packed back to back into buffer.  The buffer must not be modified until the query completes.
+
+    function PackedRows (buffer, layout, rows) {
+      return {
+        is_packed: true,
+        value: buffer,
+        row_size: layout.row_size,
+        ind_size: layout.ind_size,
+        row_count: rows > 0
+          ? rows
+          : Math.floor(buffer.length / layout.row_size),
+        columns: layout.columns
+      }
+    }
+
+    // rows of objects (or arrays) which the driver transposes into one parameter per column.
+    // each column is { key: property name or index, type: optional sql type taking the values }
+
+    function ColumnsFromRows (rows, columns) {
+      return {
+        is_transposed: true,
+        rows: rows,
+        columns: columns
       }
-      return v
     }
 
     function Table (typeName, cols) {
@@ -370,15 +468,14 @@ var userModule = (function () {
         schema: p.schema || 'dbo'
       }
       if (p.hasOwnProperty('columns') && p.hasOwnProperty('rows')) {
-        var cols = p.columns
-        var rows = p.rows
-        var c
-        tp.row_count = rows.length
-        for (c = 0; c < cols.length; ++c) {
-          var v = fromRow(rows, c)
-          var ty = cols[c].type
-          tp.table_value_param[c] = getSqlTypeFromDeclaredType(ty, v)
-        }
+        var cols = p.columns.map(function (col, c) {
+          return {
+            key: c,
+            type: getSqlTypeFromDeclaredType(col.type, null)
+          }
+        })
+        tp.row_count = p.rows.length
+        tp.table_value_param = [ColumnsFromRows(p.rows, cols)]
       }
 
       return tp
@@ -454,6 +551,33 @@ var userModule = (function () {
       }
     }
 
+    // a table value parameter whose rows, objects keyed by column name, are read from an
+    // object mode Readable, an async iterator or an iterable and sent a chunk at a time.
+
+    function TvpFromStream (table, source, chunkSize) {
+      var size = chunkSize > 0 ? chunkSize : 1000
+      var tp = TvpFromTable({
+        name: table.name,
+        schema: table.schema,
+        columns: table.columns,
+        rows: []
+      })
+      var cols = table.columns.map(function (col) {
+        return {
+          key: col.name,
+          type: getSqlTypeFromDeclaredType(col.type, null)
+        }
+      })
+      tp.row_source = {
+        chunks: new rowChunkModule.RowChunker(source, size),
+        chunk_size: size,
+        columns: function (rows) {
+          return ColumnsFromRows(rows, cols)
+        }
+      }
+      return tp
+    }
+
     return {
       TzOffsetQuery: TzOffsetQuery,
       TimeoutQuery: TimeoutQuery,
@@ -492,7 +616,12 @@ var userModule = (function () {
       SmallDateTime: DateTime2,
       DateTimeOffset: DateTimeOffset,
       TvpFromTable: TvpFromTable,
-      Table: Table
+      TvpFromStream: TvpFromStream,
+      ColumnsFromRows: ColumnsFromRows,
+      getSqlTypeFromDeclaredType: getSqlTypeFromDeclaredType,
+      Table: Table,
+      RowLayout: RowLayout,
+      PackedRows: PackedRows
     }
   }
 
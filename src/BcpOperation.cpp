@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <BcpOperation.h>
+#include <BoundDatumSet.h>
+
+namespace mssql
+{
+	static Local<Value> get(Local<Object> o, const char *v)
+	{
+		nodeTypeFactory fact;
+		return o->Get(fact.newString(v));
+	}
+
+	BcpOperation::BcpOperation(
+		const shared_ptr<OdbcConnection> &connection,
+		const Handle<Object> bcp_object,
+		const Handle<Object> callback) :
+		OdbcOperation(connection, callback),
+		_copied(0)
+	{
+		_params = make_shared<BoundDatumSet>();
+		_options = make_shared<BcpOptions>();
+		_options->table_name = FromV8String(get(bcp_object, "table_name")->ToString());
+		_options->hints = FromV8String(get(bcp_object, "hints")->ToString());
+		_options->batch_size = get(bcp_object, "batch_size")->Int32Value();
+		_options->keep_identity = get(bcp_object, "keep_identity")->BooleanValue();
+		const auto ordinals = get(bcp_object, "ordinals");
+		if (ordinals->IsArray()) {
+			const auto arr = ordinals.As<Array>();
+			for (uint32_t i = 0; i < arr->Length(); ++i) {
+				_options->ordinals.push_back(arr->Get(i)->Int32Value());
+			}
+		}
+		const auto file_name = get(bcp_object, "file_name");
+		if (file_name->IsString()) {
+			_options->file_name = FromV8String(file_name->ToString());
+			_options->delimiter = static_cast<char>(get(bcp_object, "delimiter")->Int32Value());
+			_options->quote = static_cast<char>(get(bcp_object, "quote")->Int32Value());
+			_options->header = get(bcp_object, "header")->BooleanValue();
+		}
+	}
+
+	bool BcpOperation::parameter_error_to_user_callback(const uint32_t param, const char* error) const
+	{
+		nodeTypeFactory fact;
+
+		_params->clear();
+
+		stringstream full_error;
+		full_error << "IMNOD: [msnodesql] Bulk copy column " << param + 1 << ": " << error;
+
+		auto err = fact.error(full_error);
+		const auto imn = fact.newString("IMNOD");
+		err->Set(fact.newString("sqlstate"), imn);
+		err->Set(fact.newString("code"), fact.newInteger(-1));
+
+		Local<Value> args[1];
+		args[0] = err;
+		const auto argc = 1;
+
+		fact.scopedCallback(_callback, argc, args);
+
+		return false;
+	}
+
+	bool BcpOperation::bind_parameters(Handle<Array> &node_params) const
+	{
+		const auto res = _params->bind(node_params);
+		if (!res)
+		{
+			parameter_error_to_user_callback(_params->first_error, _params->err);
+		}
+
+		return res;
+	}
+
+	bool BcpOperation::TryInvokeOdbc()
+	{
+		if (!_options->file_name.empty()) return _connection->try_bcp_file(*_options, _copied);
+		return _connection->try_bcp(*_options, _params, _copied);
+	}
+
+	Local<Value> BcpOperation::CreateCompletionArg()
+	{
+		nodeTypeFactory fact;
+		return fact.newInt64(_copied);
+	}
+}
@@ -0,0 +1,49 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: BcpOperation.h
+// Contents: bulk copy column arrays into a table with the driver bcp api
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OdbcOperation.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+	class BoundDatumSet;
+	struct BcpOptions;
+
+	class BcpOperation : public OdbcOperation
+	{
+	public:
+		BcpOperation(const shared_ptr<OdbcConnection> &connection, Handle<Object> bcp_object, Handle<Object> callback);
+		bool bind_parameters(Handle<Array> & node_params) const;
+		bool TryInvokeOdbc() override;
+		Local<Value> CreateCompletionArg() override;
+		shared_ptr<BoundDatumSet> bound_params() const override { return _params; }
+
+	private:
+		bool parameter_error_to_user_callback(uint32_t param, const char* error) const;
+		shared_ptr<BcpOptions> _options;
+		shared_ptr<BoundDatumSet> _params;
+		SQLLEN _copied;
+	};
+}
@@ -32,6 +32,11 @@ namespace mssql
 		  return more;
 	   }
 
+	   size_t Bytes() const override
+	   {
+		  return len;
+	   }
+
     private:
 
 		static char *clone(shared_ptr<DatumStorage::char_vec_t> sp, size_t len)
@@ -8,6 +8,25 @@ namespace mssql
 	const int sql_server_2008_default_datetime_precision = 34;
 	const int sql_server_2008_default_timestamp_precision = 27;
 	const int sql_server_2008_default_datetime_scale = 7;
+	const int sql_server_max_varchar_size = 8000;
+
+	// BigInt arrived in v8 6.7; an older engine never passes one.
+#if V8_MAJOR_VERSION > 6 || (V8_MAJOR_VERSION == 6 && V8_MINOR_VERSION >= 7)
+#define MSSQL_V8_BIGINT 1
+#endif
+
+	static vector<Local<Value>> cells_of(const Local<Value>& p)
+	{
+		const auto arr = Local<Array>::Cast(p);
+		const auto len = arr->Length();
+		vector<Local<Value>> cells;
+		cells.reserve(len);
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			cells.push_back(arr->Get(i));
+		}
+		return cells;
+	}
 
 	static Local<Boolean> get_as_bool(const Local<Value> o, const char* v)
 	{
@@ -77,6 +96,190 @@ namespace mssql
 		return val->ToString();
 	}
 
+	// column of a row packed buffer - value and indicator are bound in place at their offsets
+	// within the first row, odbc steps both on by row_size for every subsequent row.
+
+	bool BoundDatum::bind_packed(Local<Value>& p, char* rows, const SQLLEN row_size)
+	{
+		const auto po = p->ToObject();
+		const SQLLEN col_offset = get_as_value(po, "offset")->Int32Value();
+		const SQLLEN ind_offset = get_as_value(po, "ind_offset")->Int32Value();
+		const SQLLEN size = get_as_value(po, "size")->Int32Value();
+
+		if (col_offset < 0 || size <= 0 || col_offset + size > row_size
+			|| ind_offset < 0 || ind_offset + static_cast<SQLLEN>(sizeof(SQLLEN)) > row_size)
+		{
+			err = static_cast<char*>("Invalid packed column layout");
+			return false;
+		}
+
+		js_type = JS_BUFFER;
+		param_type = SQL_PARAM_INPUT;
+		c_type = static_cast<SQLSMALLINT>(get_as_value(po, "c_type")->Int32Value());
+		sql_type = static_cast<SQLSMALLINT>(get_as_value(po, "sql_type")->Int32Value());
+		param_size = get_as_value(po, "precision")->Int32Value();
+		digits = static_cast<SQLSMALLINT>(get_as_value(po, "scale")->Int32Value());
+		buffer = rows + col_offset;
+		buffer_len = size;
+		_ind_ptr = reinterpret_cast<SQLLEN*>(rows + ind_offset);
+		definedPrecision = c_type == SQL_C_NUMERIC;
+
+		return true;
+	}
+
+
+	bool BoundDatum::begin_rows(const Local<Object> type, const uint32_t rows)
+	{
+		if (!get_as_value(type, "is_output")->IsUndefined()) return false;
+		const auto v = get_as_value(type, "sql_type");
+		if (!v->IsNumber()) return false;
+		sql_type = static_cast<SQLSMALLINT>(v->Int32Value());
+		param_type = SQL_PARAM_INPUT;
+		auto declared = type;
+		assign_precision(declared);
+		_rowsInPlace = true;
+
+		switch (sql_type)
+		{
+		case SQL_INTEGER:
+			reserve_int32(rows);
+			break;
+
+		case SQL_TINYINT:
+			reserve_int32(rows);
+			sql_type = SQL_TINYINT;
+			break;
+
+		case SQL_SMALLINT:
+			reserve_uint32(rows);
+			sql_type = SQL_SMALLINT;
+			break;
+
+		case SQL_BIGINT:
+			reserve_integer(rows);
+			break;
+
+		case SQL_BIT:
+			reserve_boolean(rows);
+			break;
+
+		case SQL_DOUBLE:
+		case SQL_FLOAT:
+		case SQL_REAL:
+			{
+				const auto float_type = sql_type;
+				reserve_double(rows);
+				sql_type = float_type;
+			}
+			break;
+
+		case SQL_SS_TIME2:
+		case SQL_TYPE_DATE:
+		case SQL_TYPE_TIMESTAMP:
+		case SQL_SS_TIMESTAMPOFFSET:
+			reserve_time_stamp_offset(rows);
+			break;
+
+		case SQL_NUMERIC:
+		case SQL_CHAR:
+		case SQL_VARCHAR:
+		case SQL_WVARCHAR:
+		case SQL_WLONGVARCHAR:
+		case SQL_VARBINARY:
+		case SQL_LONGVARBINARY:
+			_rowsInPlace = false;
+			break;
+
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+	// the storage reserved by begin_rows is told apart by its c type. false, with nothing
+	// written, for a value of a kind the column's type would not carry faithfully, such as a
+	// string given for a date; the caller then binds the column from its values as given.
+
+	bool BoundDatum::put_row(const uint32_t row, const Local<Value>& v)
+	{
+		if (v->IsNull())
+		{
+			_indvec[row] = SQL_NULL_DATA;
+			return true;
+		}
+		switch (c_type)
+		{
+		case SQL_C_SLONG:
+			if (!v->IsInt32()) return false;
+			(*_storage->int32vec_ptr)[row] = v->Int32Value();
+			break;
+
+		case SQL_C_ULONG:
+			if (!v->IsUint32()) return false;
+			(*_storage->uint32vec_ptr)[row] = v->Uint32Value();
+			break;
+
+		case SQL_C_SBIGINT:
+#ifdef MSSQL_V8_BIGINT
+			if (v->IsBigInt())
+			{
+				(*_storage->int64vec_ptr)[row] = v.As<v8::BigInt>()->Int64Value();
+				break;
+			}
+#endif
+			if (!v->IsNumber()) return false;
+			(*_storage->int64vec_ptr)[row] = v->IntegerValue();
+			break;
+
+		case SQL_C_BIT:
+			if (!v->IsBoolean() && !v->IsNumber()) return false;
+			(*_storage->charvec_ptr)[row] = v->BooleanValue() ? 1 : 0;
+			break;
+
+		case SQL_C_DOUBLE:
+			if (!v->IsNumber()) return false;
+			(*_storage->doublevec_ptr)[row] = v->NumberValue();
+			break;
+
+		default:
+			{
+				if (!v->IsDate()) return false;
+				TimestampColumn sql_date(v->NumberValue());
+				sql_date.to_timestamp_offset((*_storage->timestampoffsetvec_ptr)[row]);
+				_indvec[row] = sizeof(SQL_SS_TIMESTAMPOFFSET_STRUCT);
+			}
+			return true;
+		}
+		_indvec[row] = 0;
+		return true;
+	}
+
+	bool BoundDatum::end_rows(const vector<Local<Value>>& cells)
+	{
+		if (_rowsInPlace) return true;
+		switch (sql_type)
+		{
+		case SQL_NUMERIC:
+			bind_numeric_cells(cells);
+			break;
+
+		case SQL_CHAR:
+		case SQL_VARCHAR:
+			bind_var_char_cells(cells);
+			break;
+
+		case SQL_WVARCHAR:
+		case SQL_WLONGVARCHAR:
+			bind_w_var_char_cells(cells);
+			break;
+
+		default:
+			bind_var_binary_cells(cells);
+			break;
+		}
+		return err == nullptr;
+	}
 
 	void BoundDatum::bind_null(const Local<Value>& p)
 	{
@@ -128,7 +331,7 @@ namespace mssql
 	void BoundDatum::bind_var_char(const Local<Value>& p)
 	{
 		const auto str_param = p->ToString();
-		SQLULEN precision = str_param->Length();
+		SQLULEN precision = str_param->Utf8Length();
 		if (param_size > 0) precision = min(param_size, precision);
 		bind_var_char(p, static_cast<int>(precision));
 	}
@@ -150,25 +353,77 @@ namespace mssql
 	void BoundDatum::bind_var_char(const Local<Value>& p, const int precision)
 	{
 		reserve_var_char(precision);
+		if (precision > sql_server_max_varchar_size) param_size = 0;
 		if (!p->IsNull())
 		{
 			const auto str_param = p->ToString();
-			str_param->WriteUtf8(_storage->charvec_ptr->data(), precision);
-			_indvec[0] = precision;
+			_indvec[0] = write_narrow(str_param, _storage->charvec_ptr->data(), precision);
 		}
 	}
 
-	int get_max_str_len(const Local<Value>& p)
+	// ascii text is copied one byte per character, anything else is encoded as utf8.
+
+	int BoundDatum::write_narrow(const Local<String>& str, char* dest, const int len)
 	{
-		auto str_len = 0;
-		auto arr = Local<Array>::Cast(p);
-		const auto len = arr->Length();
-		for (uint32_t i = 0; i < len; ++i)
+		if (str->Utf8Length() == str->Length())
+		{
+			return str->WriteOneByte(reinterpret_cast<uint8_t*>(dest), 0, len, String::NO_NULL_TERMINATION);
+		}
+		return str->WriteUtf8(dest, len, nullptr, String::NO_NULL_TERMINATION);
+	}
+
+	void BoundDatum::reserve_var_char_array(const size_t max_str_len, const size_t array_len)
+	{
+		js_type = JS_STRING;
+		c_type = SQL_C_CHAR;
+		sql_type = SQL_VARCHAR;
+		digits = 0;
+		_indvec.resize(array_len);
+		_storage->ReserveChars(array_len * max_str_len);
+		buffer = _storage->charvec_ptr->data();
+		buffer_len = max_str_len;
+		param_size = max_str_len > sql_server_max_varchar_size ? 0 : max_str_len;
+	}
+
+	// a column of ascii strings is sent one byte per character. If any value needs more
+	// than that the whole column is sent as utf16 so the server converts it to the
+	// column collation rather than the client code page.
+
+	void BoundDatum::bind_var_char_array(const Local<Value>& p)
+	{
+		bind_var_char_cells(cells_of(p));
+	}
+
+	void BoundDatum::bind_var_char_cells(const vector<Local<Value>>& cells)
+	{
+		const auto array_len = cells.size();
+		size_t max_str_len = 1;
+		for (const auto & elem : cells)
 		{
-			const auto str = arr->Get(i)->ToString();
-			if (str->Length() > str_len) str_len = str->Length();
+			if (elem->IsNull()) continue;
+			const auto str = elem->ToString();
+			const auto len = str->Length();
+			if (str->Utf8Length() != len)
+			{
+				bind_w_var_char_cells(cells);
+				return;
+			}
+			max_str_len = max(max_str_len, static_cast<size_t>(len));
+		}
+		reserve_var_char_array(max_str_len, array_len);
+
+		auto itr = _storage->charvec_ptr->data();
+		for (size_t i = 0; i < array_len; ++i)
+		{
+			_indvec[i] = SQL_NULL_DATA;
+			const auto & elem = cells[i];
+			if (!elem->IsNull())
+			{
+				const auto str = elem->ToString();
+				_indvec[i] = str->WriteOneByte(reinterpret_cast<uint8_t*>(itr), 0, static_cast<int>(max_str_len), String::NO_NULL_TERMINATION);
+			}
+			itr += max_str_len;
 		}
-		return str_len;
 	}
 
 	void BoundDatum::reserve_w_var_char_array(const size_t max_str_len, const size_t array_len)
@@ -187,20 +442,29 @@ namespace mssql
 
 	void BoundDatum::bind_w_var_char_array(const Local<Value>& p)
 	{
-		const auto max_str_len = get_max_str_len(p);
-		auto arr = Local<Array>::Cast(p);
-		const auto array_len = arr->Length();
+		bind_w_var_char_cells(cells_of(p));
+	}
+
+	void BoundDatum::bind_w_var_char_cells(const vector<Local<Value>>& cells)
+	{
+		// an all null column still declares a non zero width, as the narrow path does.
+		auto max_str_len = 1;
+		for (const auto & elem : cells)
+		{
+			if (!elem->IsNull()) max_str_len = max(max_str_len, elem->ToString()->Length());
+		}
+		const auto array_len = cells.size();
 		const auto size = sizeof(uint16_t);
 		reserve_w_var_char_array(max_str_len, array_len);
 
 		auto itr = _storage->uint16vec_ptr->begin();
-		for (uint32_t i = 0; i < array_len; ++i)
+		for (size_t i = 0; i < array_len; ++i)
 		{
 			_indvec[i] = SQL_NULL_DATA;
-			const auto elem = arr->Get(i);
+			const auto & elem = cells[i];
 			if (!elem->IsNull())
 			{
-				const auto str = arr->Get(i)->ToString();
+				const auto str = elem->ToString();
 				const auto width = str->Length() * size;
 				_indvec[i] = width;
 				auto written = str->Write(&*itr, 0, max_str_len);
@@ -235,20 +499,6 @@ namespace mssql
 		}
 	}
 
-	size_t get_max_object_len(const Local<Value>& p)
-	{
-		size_t obj_len = 0;
-		auto arr = Local<Array>::Cast(p);
-		const auto len = arr->Length();
-		for (uint32_t i = 0; i < len; ++i)
-		{
-			const auto o = arr->Get(i)->ToObject();
-			const auto width = node::Buffer::Length(o);
-			if (width > obj_len) obj_len = width;
-		}
-		return obj_len;
-	}
-
 	void BoundDatum::bind_long_var_binary(Local<Value>& p)
 	{
 		bind_var_binary(p);
@@ -343,6 +593,15 @@ namespace mssql
 		param_size = rows; // max no of rows.
 		_indvec[0] = rows; // no of rows.
 		digits = 0;
+
+		const auto chunk_size = get_as_value(p->ToObject(), "chunk_size");
+		if (chunk_size->IsNumber() && chunk_size->Int32Value() > 0)
+		{
+			// rows are sent at execution a chunk at a time, each chunk at most chunk_size rows.
+			tvp_chunk_rows = rows;
+			param_size = chunk_size->Int32Value();
+			_indvec[0] = SQL_DATA_AT_EXEC;
+		}
 	}
 
 	void BoundDatum::bind_var_binary(Local<Value>& p)
@@ -363,15 +622,29 @@ namespace mssql
 
 	void BoundDatum::bind_var_binary_array(const Local<Value>& p)
 	{
-		auto arr = Local<Array>::Cast(p);
-		const auto array_len = arr->Length();
-		const auto max_obj_len = get_max_object_len(p);
+		bind_var_binary_cells(cells_of(p));
+	}
+
+	void BoundDatum::bind_var_binary_cells(const vector<Local<Value>>& cells)
+	{
+		const auto array_len = cells.size();
+		size_t max_obj_len = 0;
+		for (const auto & elem : cells)
+		{
+			if (elem->IsNull()) continue;
+			if (!node::Buffer::HasInstance(elem))
+			{
+				err = static_cast<char*>("Invalid parameter type");
+				return;
+			}
+			max_obj_len = max(max_obj_len, node::Buffer::Length(elem));
+		}
 		reserve_var_binary_array(max_obj_len, array_len);
 		auto itr = _storage->charvec_ptr->data();
-		for (uint32_t i = 0; i < array_len; ++i)
+		for (size_t i = 0; i < array_len; ++i)
 		{
 			_indvec[i] = SQL_NULL_DATA;
-			const auto elem = arr->Get(i);
+			const auto & elem = cells[i];
 			if (!elem->IsNull())
 			{
 				const auto o = elem->ToObject();
@@ -429,6 +702,24 @@ namespace mssql
 		digits = 0;
 	}
 
+	// numbers are parsed from their shortest round trip string, so the decimal the caller
+	// sees is the one bound. decimal strings and BigInts are bound exactly.
+
+	static bool numeric_from_value(const Local<Value>& p, const int max_scale, numeric_value& n)
+	{
+		auto valid = p->IsString() || p->IsNumber();
+#ifdef MSSQL_V8_BIGINT
+		valid = valid || p->IsBigInt();
+#endif
+		if (!valid) return false;
+		const auto str = p->ToString();
+		char tmp[128];
+		if (str->Length() >= static_cast<int>(sizeof(tmp))) return false;
+		const auto written = str->WriteUtf8(tmp, sizeof(tmp) - 1, nullptr, String::NO_NULL_TERMINATION);
+		tmp[written] = 0;
+		return parse_numeric(tmp, max_scale, n);
+	}
+
 	void BoundDatum::bind_numeric(const Local<Value>& p)
 	{
 		reserve_numeric(1);
@@ -436,36 +727,72 @@ namespace mssql
 		_indvec[0] = SQL_NULL_DATA;
 		if (!p->IsNull())
 		{
-			const auto d = p->NumberValue();
-			auto& vec = *_storage->numeric_ptr;
-			auto& ns = vec[0];
-			encode_numeric_struct(d, static_cast<int>(param_size), digits, ns);
+			numeric_value n;
+			if (!numeric_from_value(p, digits > 0 ? digits : -1, n))
+			{
+				err = static_cast<char*>("Invalid numeric parameter");
+				return;
+			}
+			auto& ns = (*_storage->numeric_ptr)[0];
+			encode_numeric_struct(n, static_cast<int>(param_size), ns);
 			param_size = ns.precision;
 			digits = ns.scale;
 			_indvec[0] = sizeof(SQL_NUMERIC_STRUCT);
 		}
 	}
 
+	// the whole column shares one precision and scale in the descriptor, so all values are
+	// parsed first, then each is brought to the widest scale seen before it is encoded.
+
 	void BoundDatum::bind_numeric_array(const Local<Value>& p)
 	{
-		auto arr = Local<Array>::Cast(p);
-		const int len = arr->Length();
+		bind_numeric_cells(cells_of(p));
+	}
+
+	void BoundDatum::bind_numeric_cells(const vector<Local<Value>>& cells)
+	{
+		const auto len = static_cast<int>(cells.size());
 		reserve_numeric(len);
-		auto& vec = *_storage->numeric_ptr;
+		vector<numeric_value> values(len);
+		const auto max_scale = digits > 0 ? digits : -1;
+		auto scale = 0;
 		for (auto i = 0; i < len; ++i)
 		{
-			auto& ns = vec[i];
 			_indvec[i] = SQL_NULL_DATA;
-			const auto elem = arr->Get(i);
-			if (!elem->IsNull())
+			const auto & elem = cells[i];
+			if (elem->IsNull()) continue;
+			if (!numeric_from_value(elem, max_scale, values[i]))
+			{
+				err = static_cast<char*>("Invalid numeric parameter");
+				return;
+			}
+			_indvec[i] = sizeof(SQL_NUMERIC_STRUCT);
+			scale = max(scale, values[i].scale);
+		}
+
+		auto precision = 1;
+		for (auto i = 0; i < len; ++i)
+		{
+			if (_indvec[i] == SQL_NULL_DATA) continue;
+			auto& n = values[i];
+			if (!rescale_numeric(n, scale))
 			{
-				const auto d = elem->NumberValue();
-				encode_numeric_struct(d, static_cast<int>(param_size), digits, ns);
-				param_size = ns.precision;
-				digits = ns.scale;
-				_indvec[i] = sizeof(SQL_NUMERIC_STRUCT);
+				err = static_cast<char*>("Invalid numeric parameter");
+				return;
 			}
+			precision = max(precision, n.digits);
 		}
+
+		precision = max(precision, scale);
+		if (param_size > 0) precision = static_cast<int>(param_size);
+		auto& vec = *_storage->numeric_ptr;
+		for (auto i = 0; i < len; ++i)
+		{
+			if (_indvec[i] == SQL_NULL_DATA) continue;
+			encode_numeric_struct(values[i], precision, vec[i]);
+		}
+		param_size = precision;
+		digits = static_cast<SQLSMALLINT>(scale);
 	}
 
 	void BoundDatum::reserve_numeric(const SQLLEN len)
@@ -1270,7 +1597,7 @@ namespace mssql
 	{
 		if (pp->IsArray())
 		{
-			bind_w_var_char_array(pp);
+			bind_var_char_array(pp);
 		}
 		else
 		{
@@ -1282,7 +1609,7 @@ namespace mssql
 	{
 		if (pp->IsArray())
 		{
-			bind_w_var_char_array(pp);
+			bind_var_char_array(pp);
 		}
 		else
 		{
@@ -1422,7 +1749,10 @@ namespace mssql
 			break;
 
 		case SQL_NUMERIC:
-			sql_numeric(pp);
+			{
+				sql_numeric(pp);
+				if (err) return false;
+			}
 			break;
 
 		case SQL_CHAR:
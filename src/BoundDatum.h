@@ -10,6 +10,17 @@ namespace mssql
 	class BoundDatum {
 	public:
 		bool bind(Local<Value> &p);
+		bool bind_packed(Local<Value> &p, char *rows, SQLLEN row_size);
+
+		// a typed column of transposed rows. begin_rows reserves storage for every row, or is
+		// false for a type it cannot fill this way. Fixed width values are then written in
+		// place by put_row as the rows are walked; the others are gathered by the caller and
+		// written by end_rows once the widest text or binary, or largest decimal scale, is known.
+		// either is false when the values do not fit the type, and the caller binds them as given.
+		bool begin_rows(Local<Object> type, uint32_t rows);
+		bool rows_in_place() const { return _rowsInPlace; }
+		bool put_row(uint32_t row, const Local<Value> & v);
+		bool end_rows(const vector<Local<Value>> & cells);
 		void reserve_column_type(SQLSMALLINT type, size_t len);
 
 		bool get_defined_precision() const {
@@ -23,6 +34,9 @@ namespace mssql
 		Local<Value> unbind() const;
 		
 		vector<SQLLEN> & get_ind_vec()  { return _indvec; }
+
+		// packed columns read their indicator from the caller's row buffer
+		SQLLEN * get_ind_ptr() { return _ind_ptr != nullptr ? _ind_ptr : _indvec.data(); }
 		
 		char *getErr() const { return err; }
 
@@ -42,7 +56,10 @@ namespace mssql
 			definedScale(false),
 			err(nullptr),
 			is_tvp(false),
-			tvp_no_cols(0)
+			tvp_no_cols(0),
+			tvp_chunk_rows(0),
+			_ind_ptr(nullptr),
+			_rowsInPlace(false)
 		{
 			_indvec = vector<SQLLEN>(1);
 			_storage = make_shared<DatumStorage>();
@@ -72,11 +89,15 @@ namespace mssql
 		uint32_t offset;
 		bool is_tvp;
 		int tvp_no_cols;
+		// rows bound in the first chunk of a table value parameter streamed at execution.
+		SQLLEN tvp_chunk_rows;
 
 
 	private:
 	
 		vector<SQLLEN> _indvec;
+		SQLLEN * _ind_ptr;
+		bool _rowsInPlace;
 		shared_ptr<DatumStorage> _storage;
 		bool definedPrecision;
 		bool definedScale;
@@ -95,6 +116,7 @@ namespace mssql
 		void bind_w_var_char(const Local<Value>& p, int str_len);
 		void reserve_w_var_char_array(size_t maxStrLen, size_t  arrayLen);
 		void bind_w_var_char_array(const Local<Value> & p);
+		void bind_w_var_char_cells(const vector<Local<Value>> & cells);
 
 		void bind_boolean(const Local<Value> & p);
 		void reserve_boolean(SQLLEN len);
@@ -105,6 +127,7 @@ namespace mssql
 
 		void bind_numeric(const Local<Value> & p);
 		void bind_numeric_array(const Local<Value> & p);
+		void bind_numeric_cells(const vector<Local<Value>> & cells);
 		void reserve_numeric(SQLLEN len);
 
 		void bind_int32(const Local<Value> & p);
@@ -146,6 +169,7 @@ namespace mssql
 
 		void bind_var_binary( Local<Value> & p);
 		void bind_var_binary_array(const Local<Value> & p);
+		void bind_var_binary_cells(const vector<Local<Value>> & cells);
 		void reserve_var_binary_array(size_t maxObjLen, size_t  arrayLen);
 
 		bool bind_datum_type(Local<Value>& p);
@@ -158,6 +182,10 @@ namespace mssql
 		void bind_var_char(const Local<Value> & pp);
 		void bind_var_char(const Local<Value> & p, int precision);
 		void reserve_var_char(size_t precision);
+		void reserve_var_char_array(size_t maxStrLen, size_t arrayLen);
+		void bind_var_char_array(const Local<Value> & p);
+		void bind_var_char_cells(const vector<Local<Value>> & cells);
+		static int write_narrow(const Local<String> & str, char * dest, int len);
 		bool user_bind(Local<Value> &p, Local<Value> &v);
 		void assign_precision(Local<Object> &pv);
 
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <chrono>
 #include <BoundDatum.h>
 #include <BoundDatumSet.h>
 #include <ResultSet.h>
@@ -8,7 +9,10 @@ namespace mssql
 	BoundDatumSet::BoundDatumSet() : 
 		err(nullptr), 
 		first_error(0), 
-		_output_param_count(-1)
+		_output_param_count(-1),
+		_row_size(0),
+		_row_count(0),
+		_bind_micros(0)
 	{
 		_bindings = make_shared<param_bindings>();
 	}
@@ -32,15 +36,14 @@ namespace mssql
 		return val;
 	}
 
-	int get_tvp_col_count(Local<Value> &v)
+	bool is_transposed(Local<Value> &v)
 	{
-		auto tvp_columns = get(v.As<Object>(), "table_value_param");
-		const auto cols = tvp_columns.As<Array>();
-		const auto count = cols->Length();
-		return count;
+		if (!v->IsObject() || v->IsArray()) return false;
+		const auto transposed = get(v.As<Object>(), "is_transposed");
+		return transposed->IsBoolean() && transposed->BooleanValue();
 	}
 
-	bool BoundDatumSet::tvp(Local<Value> &v) const
+	bool BoundDatumSet::tvp(Local<Value> &v)
 	{
 		auto tvp_columns = get(v.As<Object>(), "table_value_param");
 		if (tvp_columns->IsNull()) return false;
@@ -50,8 +53,13 @@ namespace mssql
 		const auto count = cols->Length();
 	
 		for (uint32_t i = 0; i < count; ++i) {
-			auto binding = make_shared<BoundDatum>();
 			auto p = cols->Get(i);
+			if (is_transposed(p))
+			{
+				if (!transposed(p)) return false;
+				continue;
+			}
+			auto binding = make_shared<BoundDatum>();
 			const auto res = binding->bind(p);
 			if (!res) break;
 			_bindings->push_back(binding);
@@ -59,7 +67,210 @@ namespace mssql
 		return true;
 	}
 
+	// an array of row objects (or row arrays) and a list of column keys, expanded to one bound
+	// parameter per column. The rows are walked once, each key read from every row; a missing
+	// property is bound as null. A column whose type object the datum can fill row by row has
+	// its values written straight into the bound buffers. Any other column is gathered into an
+	// array bound as before, where the type object receives the values, unless they turned out
+	// not to fit it.
+
+	bool BoundDatumSet::transposed(Local<Value> &v)
+	{
+		nodeTypeFactory fact;
+		const auto o = v.As<Object>();
+		const auto rows_val = get(o, "rows");
+		const auto cols_val = get(o, "columns");
+		if (!rows_val->IsArray() || !cols_val->IsArray())
+		{
+			err = static_cast<char*>("Transposed rows require rows and columns arrays");
+			return false;
+		}
+
+		const auto rows = rows_val.As<Array>();
+		const auto cols = cols_val.As<Array>();
+		const auto row_count = rows->Length();
+		const auto col_count = cols->Length();
+		const Local<Value> null_val = fact.null();
+
+		vector<Local<Value>> keys;
+		vector<Local<Value>> types;
+		vector<shared_ptr<BoundDatum>> bindings;
+		vector<bool> typed;
+		vector<bool> in_place;
+		vector<bool> as_given(col_count, false);
+		vector<vector<Local<Value>>> cells(col_count);
+		for (uint32_t c = 0; c < col_count; ++c)
+		{
+			const auto col = cols->Get(c).As<Object>();
+			const auto type = get(col, "type");
+			auto binding = make_shared<BoundDatum>();
+			const auto direct = row_count > 0 && type->IsObject() && binding->begin_rows(type.As<Object>(), row_count);
+			if (!direct) binding = make_shared<BoundDatum>();
+			keys.push_back(get(col, "key"));
+			types.push_back(type);
+			bindings.push_back(binding);
+			typed.push_back(direct);
+			in_place.push_back(direct && binding->rows_in_place());
+			if (!in_place[c]) cells[c].reserve(row_count);
+		}
+
+		const auto value_at = [&](const uint32_t r, const uint32_t c)
+		{
+			const auto row = rows->Get(r);
+			if (!row->IsObject()) return null_val;
+			const auto val = row.As<Object>()->Get(keys[c]);
+			return val->IsUndefined() ? null_val : val;
+		};
+
+		// a column whose values do not fit its type is bound from the values as given.
+		const auto give_up_type = [&](const uint32_t c)
+		{
+			typed[c] = false;
+			in_place[c] = false;
+			as_given[c] = true;
+			bindings[c] = make_shared<BoundDatum>();
+		};
+
+		for (uint32_t r = 0; r < row_count; ++r)
+		{
+			const auto row = rows->Get(r);
+			const auto is_obj = row->IsObject();
+			const auto row_obj = row.As<Object>();
+			for (uint32_t c = 0; c < col_count; ++c)
+			{
+				auto val = is_obj ? row_obj->Get(keys[c]) : null_val;
+				if (val->IsUndefined()) val = null_val;
+				if (!in_place[c])
+				{
+					cells[c].push_back(val);
+					continue;
+				}
+				if (bindings[c]->put_row(r, val)) continue;
+				give_up_type(c);
+				cells[c].reserve(row_count);
+				for (uint32_t earlier = 0; earlier < r; ++earlier) cells[c].push_back(value_at(earlier, c));
+				cells[c].push_back(val);
+			}
+		}
+
+		const auto value_key = fact.newString("value");
+		for (uint32_t c = 0; c < col_count; ++c)
+		{
+			if (typed[c])
+			{
+				if (bindings[c]->end_rows(cells[c]))
+				{
+					_bindings->push_back(bindings[c]);
+					continue;
+				}
+				give_up_type(c);
+			}
+			auto & binding = bindings[c];
+			// a single row is bound as a scalar value rather than an array of one.
+			Local<Value> p = null_val;
+			if (row_count == 1) p = cells[c][0];
+			else
+			{
+				const auto arr = fact.newArray(static_cast<int>(row_count));
+				for (uint32_t r = 0; r < row_count; ++r) arr->Set(r, cells[c][r]);
+				p = arr;
+			}
+			if (types[c]->IsObject() && !as_given[c])
+			{
+				types[c].As<Object>()->Set(value_key, p);
+				p = types[c];
+			}
+			if (!binding->bind(p))
+			{
+				err = binding->getErr();
+				return false;
+			}
+			_bindings->push_back(binding);
+		}
+		return true;
+	}
+
+	bool is_packed(Local<Value> &v)
+	{
+		if (!v->IsObject() || v->IsArray()) return false;
+		const auto packed = get(v.As<Object>(), "is_packed");
+		return packed->IsBoolean() && packed->BooleanValue();
+	}
+
+	// one Buffer holding row_count rows of row_size bytes, each column bound at its offset.
+	// the Buffer is not copied, it is kept alive by the js query until the statement completes.
+
+	bool BoundDatumSet::packed(Local<Value> &v)
+	{
+		const auto o = v.As<Object>();
+		const auto buf = get(o, "value");
+		if (!node::Buffer::HasInstance(buf))
+		{
+			err = static_cast<char*>("Packed rows must be provided in a Buffer");
+			return false;
+		}
+
+		const SQLLEN row_size = get(o, "row_size")->Int32Value();
+		const SQLLEN row_count = get(o, "row_count")->Int32Value();
+		const auto ind_size = get(o, "ind_size")->Int32Value();
+		const auto len = static_cast<SQLLEN>(node::Buffer::Length(buf));
+		if (ind_size != sizeof(SQLLEN))
+		{
+			err = static_cast<char*>("Packed row indicator size does not match this platform");
+			return false;
+		}
+		if (row_size <= 0 || row_count <= 0 || row_size * row_count > len)
+		{
+			err = static_cast<char*>("Packed rows exceed the length of the Buffer");
+			return false;
+		}
+
+		const auto cols = get(o, "columns").As<Array>();
+		const auto rows = node::Buffer::Data(buf);
+		for (uint32_t i = 0; i < cols->Length(); ++i)
+		{
+			auto binding = make_shared<BoundDatum>();
+			auto col = cols->Get(i);
+			if (!binding->bind_packed(col, rows, row_size))
+			{
+				err = binding->getErr();
+				first_error = i;
+				return false;
+			}
+			_bindings->push_back(binding);
+		}
+
+		_row_size = row_size;
+		_row_count = row_count;
+		return true;
+	}
+
 	bool BoundDatumSet::bind(Handle<Array> &node_params)
+	{
+		const auto start = chrono::steady_clock::now();
+		const auto res = bind_all(node_params);
+		_bind_micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+		return res;
+	}
+
+	SQLLEN BoundDatumSet::bound_bytes() const
+	{
+		if (_row_size > 0) return _row_size * _row_count;
+		// buffer_len is the width of one element for text and binary arrays, the stride odbc
+		// steps by, but covers every row for the fixed width types.
+		SQLLEN bytes = 0;
+		for (const auto & datum : *_bindings)
+		{
+			const auto per_element = datum->c_type == SQL_C_CHAR
+				|| datum->c_type == SQL_C_WCHAR
+				|| datum->c_type == SQL_C_BINARY;
+			const auto rows = static_cast<SQLLEN>(datum->get_ind_vec().size());
+			bytes += per_element ? datum->buffer_len * rows : datum->buffer_len;
+		}
+		return bytes;
+	}
+
+	bool BoundDatumSet::bind_all(Handle<Array> &node_params)
 	{
 		const auto count = node_params->Length();
 		auto res = true;
@@ -68,6 +279,23 @@ namespace mssql
 			for (uint32_t i = 0; i < count; ++i) {
 				auto binding = make_shared<BoundDatum>();
 				auto v = node_params->Get(i);
+				if (is_packed(v))
+				{
+					if (count == 1) return packed(v);
+					err = static_cast<char*>("Packed rows must be the only parameter");
+					first_error = i;
+					return false;
+				}
+				if (is_transposed(v))
+				{
+					res = transposed(v);
+					if (!res)
+					{
+						first_error = i;
+						break;
+					}
+					continue;
+				}
 				res = binding->bind(v);
 
 				switch (binding->param_type)
@@ -91,9 +319,14 @@ namespace mssql
 
 				if (binding->is_tvp)
 				{
-					const auto col_count = get_tvp_col_count(v);
-					binding->tvp_no_cols = col_count;
+					const auto bound = _bindings->size();
 					res = tvp(v);
+					binding->tvp_no_cols = static_cast<int>(_bindings->size() - bound);
+					if (!res && err)
+					{
+						first_error = i;
+						break;
+					}
 				}
 			}
 		}
@@ -21,12 +21,26 @@ namespace mssql
 		param_bindings::iterator begin() { return _bindings->begin(); }
 		param_bindings::iterator end() { return _bindings->end(); }
 
+		// non zero when all parameters are bound row wise from a single packed buffer
+		SQLLEN row_size() const { return _row_size; }
+		SQLLEN row_count() const { return _row_count; }
+
+		// time taken by the last bind, and the size of the buffers it filled.
+		int64_t bind_micros() const { return _bind_micros; }
+		SQLLEN bound_bytes() const;
+
 		char * err;
 		int first_error;
 
 	private:
-		bool tvp(Local<Value> &v) const;
+		bool tvp(Local<Value> &v);
+		bool transposed(Local<Value> &v);
+		bool packed(Local<Value> &v);
+		bool bind_all(Handle<Array> &node_params);
 		int _output_param_count;
+		SQLLEN _row_size;
+		SQLLEN _row_count;
+		int64_t _bind_micros;
 		shared_ptr<param_bindings> _bindings;
 	};
 }
@@ -40,6 +40,9 @@ namespace mssql
 
 		bool TryInvokeOdbc() override;
 
+		// only flags the statement, which the worker polling it is blocked on
+		bool ordered() const override { return false; }
+
 		Local<Value> CreateCompletionArg() override;
 	};
 }
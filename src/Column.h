@@ -33,5 +33,7 @@ namespace mssql
 		virtual ~Column();
 		virtual Handle<Value> ToValue() = 0;
 		virtual bool More() const { return false; }
+		// bytes held natively for the value, counted against the cap on a drained query.
+		virtual size_t Bytes() const { return sizeof(double); }
 	};
 }
@@ -20,6 +20,8 @@
 #include <v8.h>
 #include <Connection.h>
 #include <OdbcConnection.h>
+#include <WorkerPool.h>
+#include <Scheduler.h>
 
 namespace mssql
 {
@@ -37,19 +39,25 @@ namespace mssql
 		NODE_SET_PROTOTYPE_METHOD(tpl, "close", close);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "open", open);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "query", query);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "queryAll", query_all);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "bindQuery", bind_query);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "prepare", prepare);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "readRow", read_row);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "readColumn", read_column);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "beginTransaction", begin_transaction);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "isAlive", is_alive);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "commit", commit);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "rollback", rollback);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "nextResult", read_next_result);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "callProcedure", call_procedure);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "unbind", unbind);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "putTvpRows", put_tvp_rows);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "bulkCopy", bulk_copy);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "exportRows", export_rows);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "freeStatement", free_statement);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "cancelQuery", cancel_statement);
 		NODE_SET_PROTOTYPE_METHOD(tpl, "pollingMode", polling_mode);
+		NODE_SET_PROTOTYPE_METHOD(tpl, "timings", timings);
 	}
 
 	void Connection::initialize(Handle<Object> exports)
@@ -72,6 +80,77 @@ namespace mssql
 		const auto fn = tpl->GetFunction();
 		constructor.Reset(Isolate::GetCurrent(), fn);
 		exports->Set(connection, fn);
+		NODE_SET_METHOD(exports, "setWorkerThreads", set_worker_threads);
+		NODE_SET_METHOD(exports, "workerThreads", worker_threads);
+		NODE_SET_METHOD(exports, "setSchedulerClasses", set_scheduler_classes);
+		NODE_SET_METHOD(exports, "schedulerStats", scheduler_stats);
+	}
+
+	// size of the driver worker pool, effective only before the first operation is sent.
+
+	void Connection::set_worker_threads(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto size = info[0].As<Number>()->Int32Value();
+		nodeTypeFactory fact;
+		const auto ret = size > 0 && WorkerPool::set_size(static_cast<size_t>(size));
+		info.GetReturnValue().Set(fact.newBoolean(ret));
+	}
+
+	// the number of driver workers, or that they will start with.
+
+	void Connection::worker_threads(const FunctionCallbackInfo<Value>& info)
+	{
+		nodeTypeFactory fact;
+		info.GetReturnValue().Set(fact.newInt32(static_cast<int32_t>(WorkerPool::size())));
+	}
+
+	// priority classes as [{ name, weight, maxRunning }], the first taking operations given no
+	// class. Like the worker threads, set before any query names a class or is sent.
+
+	static vector<Scheduler::ClassOptions> class_options_from(const Local<Array> & classes)
+	{
+		nodeTypeFactory fact;
+		vector<Scheduler::ClassOptions> options;
+		for (uint32_t i = 0; i < classes->Length(); ++i)
+		{
+			const auto c = classes->Get(i).As<Object>();
+			const auto max_running = c->Get(fact.newString("maxRunning"))->Int32Value();
+			Scheduler::ClassOptions o;
+			o.name = FromV8String(c->Get(fact.newString("name"))->ToString());
+			o.weight = c->Get(fact.newString("weight"))->NumberValue();
+			o.max_running = max_running > 0 ? static_cast<size_t>(max_running) : 0;
+			options.push_back(o);
+		}
+		return options;
+	}
+
+	void Connection::set_scheduler_classes(const FunctionCallbackInfo<Value>& info)
+	{
+		nodeTypeFactory fact;
+		const auto options = class_options_from(info[0].As<Array>());
+		info.GetReturnValue().Set(fact.newBoolean(WorkerPool::set_classes(options)));
+	}
+
+	void Connection::scheduler_stats(const FunctionCallbackInfo<Value>& info)
+	{
+		nodeTypeFactory fact;
+		const auto stats = WorkerPool::instance().class_stats();
+		auto res = fact.newArray(static_cast<int>(stats.size()));
+		for (size_t i = 0; i < stats.size(); ++i)
+		{
+			const auto & s = stats[i];
+			auto o = fact.newObject();
+			o->Set(fact.newString("name"), fact.fromTwoByte(s.options.name.c_str()));
+			o->Set(fact.newString("weight"), fact.newNumber(s.options.weight));
+			o->Set(fact.newString("maxRunning"), fact.newInt64(static_cast<int64_t>(s.options.max_running)));
+			o->Set(fact.newString("queued"), fact.newInt64(s.queued));
+			o->Set(fact.newString("running"), fact.newInt64(s.running));
+			o->Set(fact.newString("dispatched"), fact.newInt64(s.dispatched));
+			o->Set(fact.newString("waitMicrosTotal"), fact.newInt64(s.wait_micros_total));
+			o->Set(fact.newString("waitMicrosMax"), fact.newInt64(s.wait_micros_max));
+			res->Set(static_cast<uint32_t>(i), o);
+		}
+		info.GetReturnValue().Set(res);
 	}
 
 	Connection::~Connection()
@@ -96,6 +175,14 @@ namespace mssql
 		info.GetReturnValue().Set(ret);
 	}
 
+	void Connection::is_alive(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto cb = info[0].As<Object>();
+		auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->is_alive(cb);
+		info.GetReturnValue().Set(ret);
+	}
+
 	void Connection::commit(const FunctionCallbackInfo<Value>& info)
 	{
 		const auto cb = info[0].As<Object>();
@@ -135,6 +222,19 @@ namespace mssql
 		info.GetReturnValue().Set(ret);
 	}
 
+	void Connection::query_all(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto query_object = info[1].As<Object>();
+		const auto params = info[2].As<Array>();
+		const auto options = info[3].As<Object>();
+		const auto callback = info[4].As<Object>();
+
+		const auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->query_all(query_id, query_object, params, options, callback);
+		info.GetReturnValue().Set(ret);
+	}
+
 	void Connection::prepare(const FunctionCallbackInfo<Value>& info)
 	{
 		const auto query_id = info[0].As<Number>();
@@ -179,6 +279,37 @@ namespace mssql
 		info.GetReturnValue().Set(ret);
 	}
 
+	void Connection::put_tvp_rows(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto params = info[1].As<Array>();
+		const auto rows = info[2].As<Number>();
+		const auto callback = info[3].As<Object>();
+		const auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->put_tvp_rows(query_id, params, rows, callback);
+		info.GetReturnValue().Set(ret);
+	}
+
+	void Connection::bulk_copy(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto bcp_object = info[0].As<Object>();
+		const auto params = info[1].As<Array>();
+		const auto callback = info[2].As<Object>();
+		const auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->bulk_copy(bcp_object, params, callback);
+		info.GetReturnValue().Set(ret);
+	}
+
+	void Connection::export_rows(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto export_object = info[1].As<Object>();
+		const auto callback = info[2].As<Object>();
+		const auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->export_rows(query_id, export_object, callback);
+		info.GetReturnValue().Set(ret);
+	}
+
 	void Connection::free_statement(const FunctionCallbackInfo<Value>& info)
 	{
 		const auto query_id = info[0].As<Number>();
@@ -211,8 +342,9 @@ namespace mssql
 	{
 		const auto query_id = info[0].As<Number>();
 		const auto callback = info[1].As<Object>();
+		const auto finish = info[2];
 		const auto connection = Unwrap<Connection>(info.This());
-		const auto ret = connection->connectionBridge->read_next_result(query_id, callback);
+		const auto ret = connection->connectionBridge->read_next_result(query_id, callback, finish);
 		info.GetReturnValue().Set(ret);
 	}
 
@@ -249,6 +381,13 @@ namespace mssql
 		const auto ret = connection->connectionBridge->polling_mode(query_id, b1, callback);
 		info.GetReturnValue().Set(ret);
 	}
+
+	void Connection::timings(const FunctionCallbackInfo<Value>& info)
+	{
+		const auto connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->timings();
+		info.GetReturnValue().Set(ret);
+	}
 }
 
 NODE_MODULE(sqlserver, mssql::Connection::initialize)
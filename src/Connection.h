@@ -39,20 +39,30 @@ namespace mssql
 		static void New(const FunctionCallbackInfo<Value>& info);
 		static void close(const FunctionCallbackInfo<Value>& info);
 		static void begin_transaction(const FunctionCallbackInfo<Value>& info);
+		static void is_alive(const FunctionCallbackInfo<Value>& info);
 		static void commit(const FunctionCallbackInfo<Value>& info);
 		static void rollback(const FunctionCallbackInfo<Value>& info);
 		static void open(const FunctionCallbackInfo<Value>& info);
 		static void query(const FunctionCallbackInfo<Value>& info);
+		static void query_all(const FunctionCallbackInfo<Value>& info);
 		static void prepare(const FunctionCallbackInfo<Value>& info);
 		static void bind_query(const FunctionCallbackInfo<Value>& info);
 		static void call_procedure(const FunctionCallbackInfo<Value>& info);
 		static void unbind(const FunctionCallbackInfo<Value>& info);
+		static void put_tvp_rows(const FunctionCallbackInfo<Value>& info);
+		static void bulk_copy(const FunctionCallbackInfo<Value>& info);
+		static void export_rows(const FunctionCallbackInfo<Value>& info);
 		static void free_statement(const FunctionCallbackInfo<Value>& info);
 		static void read_row(const FunctionCallbackInfo<Value>& info);
 		static void cancel_statement(const FunctionCallbackInfo<Value>& info);
 		static void read_column(const FunctionCallbackInfo<Value>& info);
 		static void read_next_result(const FunctionCallbackInfo<Value>& info);
 		static void polling_mode(const FunctionCallbackInfo<Value>& info);
+		static void timings(const FunctionCallbackInfo<Value>& info);
+		static void set_worker_threads(const FunctionCallbackInfo<Value>& info);
+		static void worker_threads(const FunctionCallbackInfo<Value>& info);
+		static void set_scheduler_classes(const FunctionCallbackInfo<Value>& info);
+		static void scheduler_stats(const FunctionCallbackInfo<Value>& info);
 		
 		static Persistent<Function> constructor;
 		static void api(Local<FunctionTemplate>& tpl);
@@ -0,0 +1,165 @@
+#include "stdafx.h"
+#include <CsvReader.h>
+
+namespace mssql
+{
+	const size_t csv_buffer_size = 1 << 20;
+
+	CsvReader::CsvReader(const char delimiter, const char quote) :
+		_file(nullptr),
+		_start(0),
+		_end(0),
+		_eof(false),
+		_failed(false),
+		_delimiter(delimiter),
+		_quote(quote)
+	{
+	}
+
+	CsvReader::~CsvReader()
+	{
+		if (_file != nullptr) fclose(_file);
+	}
+
+	bool CsvReader::open(const wstring & file_name)
+	{
+		if (_wfopen_s(&_file, file_name.c_str(), L"rb") != 0) return false;
+		_buffer.resize(csv_buffer_size);
+		if (!fill()) return false;
+		// skip a utf8 byte order mark
+		if (_end >= 3 && memcmp(_buffer.data(), "\xEF\xBB\xBF", 3) == 0) _start = 3;
+		return true;
+	}
+
+	// keep the unread tail at the front of the buffer and read more after it, growing
+	// the buffer when a single row does not fit.
+
+	bool CsvReader::fill()
+	{
+		if (_start > 0) {
+			memmove(_buffer.data(), _buffer.data() + _start, _end - _start);
+			_end -= _start;
+			_start = 0;
+		}
+		if (_end == _buffer.size()) _buffer.resize(_buffer.size() * 2);
+		const auto read = fread(_buffer.data() + _end, 1, _buffer.size() - _end, _file);
+		if (read == 0) {
+			if (ferror(_file)) {
+				_failed = true;
+				return false;
+			}
+			_eof = true;
+		}
+		_end += read;
+		return true;
+	}
+
+	bool CsvReader::next(vector<CsvField> & fields)
+	{
+		for (;;)
+		{
+			if (_end > _start) {
+				const auto used = parse_row(_buffer.data() + _start, _end - _start, fields);
+				if (used > 0) {
+					_start += used;
+					if (fields.size() == 1 && fields[0].len == 0 && !fields[0].quoted) continue;
+					return true;
+				}
+			}
+			if (_eof) return false;
+			if (!fill()) return false;
+		}
+	}
+
+	void CsvReader::split_plain(const char * row, const size_t len, vector<CsvField> & fields) const
+	{
+		auto p = row;
+		const auto end = row + len;
+		for (;;)
+		{
+			const auto d = static_cast<const char*>(memchr(p, _delimiter, end - p));
+			if (d == nullptr) {
+				fields.push_back({ p, static_cast<size_t>(end - p), false });
+				return;
+			}
+			fields.push_back({ p, static_cast<size_t>(d - p), false });
+			p = d + 1;
+		}
+	}
+
+	// returns the bytes used by the row including its line break, or 0 when the buffer
+	// holds only part of the row. a line without quotes is split with memchr alone.
+
+	size_t CsvReader::parse_row(const char * row, const size_t len, vector<CsvField> & fields)
+	{
+		fields.clear();
+		const auto nl = static_cast<const char*>(memchr(row, '\n', len));
+		if (nl == nullptr && !_eof) return 0;
+		const auto line = nl != nullptr ? static_cast<size_t>(nl - row) : len;
+		if (memchr(row, _quote, line) == nullptr) {
+			auto content = line;
+			if (content > 0 && row[content - 1] == '\r') --content;
+			split_plain(row, content, fields);
+			return nl != nullptr ? line + 1 : len;
+		}
+
+		_unquoted.clear();
+		_unquoted_at.clear();
+		size_t i = 0;
+		for (;;)
+		{
+			if (i < len && row[i] == _quote) {
+				const auto at = _unquoted.size();
+				++i;
+				for (;;)
+				{
+					if (i >= len) {
+						if (_eof) break;
+						return 0;
+					}
+					const auto c = row[i];
+					if (c == _quote) {
+						if (i + 1 >= len && !_eof) return 0;
+						if (i + 1 < len && row[i + 1] == _quote) {
+							_unquoted.push_back(_quote);
+							i += 2;
+							continue;
+						}
+						++i;
+						break;
+					}
+					_unquoted.push_back(c);
+					++i;
+				}
+				_unquoted_at.push_back(at);
+				fields.push_back({ nullptr, _unquoted.size() - at, true });
+				while (i < len && row[i] != _delimiter && row[i] != '\n') ++i;
+			} else {
+				auto j = i;
+				while (j < len && row[j] != _delimiter && row[j] != '\n') ++j;
+				if (j >= len && !_eof) return 0;
+				auto field_len = j - i;
+				if (field_len > 0 && row[j - 1] == '\r' && (j >= len || row[j] == '\n')) --field_len;
+				fields.push_back({ row + i, field_len, false });
+				i = j;
+			}
+
+			if (i >= len) {
+				if (!_eof) return 0;
+				break;
+			}
+			if (row[i] == '\n') {
+				++i;
+				break;
+			}
+			++i;	// delimiter
+		}
+
+		size_t q = 0;
+		for (auto & field : fields)
+		{
+			if (field.quoted) field.data = _unquoted.data() + _unquoted_at[q++];
+		}
+		return i;
+	}
+}
@@ -0,0 +1,64 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: CsvReader.h
+// Contents: scan delimited text files a row at a time for bulk copy
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <stdio.h>
+
+namespace mssql
+{
+	using namespace std;
+
+	struct CsvField
+	{
+		const char * data;
+		size_t len;
+		bool quoted;
+	};
+
+	// fields returned by next point into the reader's buffers and are valid until the
+	// following call. a quoted field may hold delimiters, line breaks and doubled quotes.
+
+	class CsvReader
+	{
+	public:
+		CsvReader(char delimiter, char quote);
+		~CsvReader();
+		bool open(const wstring & file_name);
+		bool next(vector<CsvField> & fields);
+		bool failed() const { return _failed; }
+
+	private:
+		bool fill();
+		size_t parse_row(const char * row, size_t len, vector<CsvField> & fields);
+		void split_plain(const char * row, size_t len, vector<CsvField> & fields) const;
+
+		FILE * _file;
+		vector<char> _buffer;
+		string _unquoted;
+		vector<size_t> _unquoted_at;
+		size_t _start;
+		size_t _end;
+		bool _eof;
+		bool _failed;
+		char _delimiter;
+		char _quote;
+	};
+}
@@ -0,0 +1,52 @@
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <OdbcStatement.h>
+#include <ExportOperation.h>
+#include <RowExporter.h>
+
+namespace mssql
+{
+	static Local<Value> get(Local<Object> o, const char *v)
+	{
+		nodeTypeFactory fact;
+		return o->Get(fact.newString(v));
+	}
+
+	ExportOperation::ExportOperation(
+		const shared_ptr<OdbcConnection> &connection,
+		const size_t query_id,
+		const Handle<Object> export_object,
+		const Handle<Object> callback) :
+		OdbcOperation(connection, query_id, callback)
+	{
+		_options = make_shared<ExportOptions>();
+		const auto format = FromV8String(get(export_object, "format")->ToString());
+		_options->format = format == L"ndjson" ? RowExporter::NDJSON : RowExporter::CSV;
+		_options->delimiter = static_cast<char>(get(export_object, "delimiter")->Int32Value());
+		_options->chunk_bytes = static_cast<size_t>(get(export_object, "chunk_bytes")->Int32Value());
+	}
+
+	bool ExportOperation::TryInvokeOdbc()
+	{
+		if (_statement == nullptr) return false;
+		return _statement->try_export_rows(*_options);
+	}
+
+	Local<Value> ExportOperation::CreateCompletionArg()
+	{
+		nodeTypeFactory fact;
+		auto o = fact.newObject();
+		o->Set(fact.newString("rows"), fact.newInt64(_statement->exported_rows()));
+		o->Set(fact.newString("end"), fact.newBoolean(_statement->export_end()));
+		const auto text = _statement->export_data();
+		if (text != nullptr && !text->empty()) {
+			const auto buffer = fact.newBuffer(static_cast<int>(text->size()));
+			memcpy(node::Buffer::Data(buffer), text->data(), text->size());
+			text->clear();
+			o->Set(fact.newString("data"), buffer);
+		} else {
+			o->Set(fact.newString("data"), fact.null());
+		}
+		return o;
+	}
+}
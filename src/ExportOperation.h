@@ -0,0 +1,46 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ExportOperation.h
+// Contents: fetch the rows of a query as csv or ndjson text
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OdbcOperation.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+	struct ExportOptions;
+
+	// completes with { rows, end, data } where data is a Buffer of text, or null when
+	// the text has already been written to a file descriptor.
+
+	class ExportOperation : public OdbcOperation
+	{
+	public:
+		ExportOperation(const shared_ptr<OdbcConnection> &connection, size_t query_id, Handle<Object> export_object, Handle<Object> callback);
+		bool TryInvokeOdbc() override;
+		Local<Value> CreateCompletionArg() override;
+
+	private:
+		shared_ptr<ExportOptions> _options;
+	};
+}
@@ -0,0 +1,22 @@
+#include "OdbcConnection.h"
+#include <IsAliveOperation.h>
+
+namespace mssql
+{
+	IsAliveOperation::IsAliveOperation(const shared_ptr<OdbcConnection> &connection, const Handle<Object> callback)
+		: OdbcOperation(connection, callback),
+		_alive(false)
+	{
+	}
+
+	bool IsAliveOperation::TryInvokeOdbc()
+	{
+		return _connection->try_is_alive(_alive);
+	}
+
+	Local<Value> IsAliveOperation::CreateCompletionArg()
+	{
+		nodeTypeFactory fact;
+		return fact.newBoolean(_alive);
+	}
+}
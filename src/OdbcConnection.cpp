@@ -23,6 +23,8 @@
 #include <OdbcOperation.h>
 #include <OperationManager.h>
 #include <NodeColumns.h>
+#include <BoundDatumSet.h>
+#include <CsvReader.h>
 
 namespace mssql
 {
@@ -37,7 +39,11 @@ namespace mssql
 
 		if (!environment.alloc()) { return false; }
 
-		ret = SQLSetEnvAttr(environment, SQL_ATTR_ODBC_VERSION, reinterpret_cast<SQLPOINTER>(SQL_OV_ODBC3), 0);
+		// odbc 3.8 allows asynchronous completion to be notified by event, else fall back to 3.
+		ret = SQLSetEnvAttr(environment, SQL_ATTR_ODBC_VERSION, reinterpret_cast<SQLPOINTER>(SQL_OV_ODBC3_80), 0);
+		if (!SQL_SUCCEEDED(ret)) {
+			ret = SQLSetEnvAttr(environment, SQL_ATTR_ODBC_VERSION, reinterpret_cast<SQLPOINTER>(SQL_OV_ODBC3), 0);
+		}
 		if (!SQL_SUCCEEDED(ret)) { return false; }
 		ret = SQLSetEnvAttr(environment, SQL_ATTR_CP_MATCH, reinterpret_cast<SQLPOINTER>(SQL_CP_RELAXED_MATCH), 0);
 		if (!SQL_SUCCEEDED(ret)) { return false; }
@@ -108,7 +114,7 @@ namespace mssql
 		return true;
 	}
 
-	bool OdbcConnection::try_open(const wstring& connection_string, const int timeout)
+	bool OdbcConnection::try_open(const wstring& connection_string, const int timeout, const bool mars)
 	{
 		assert(connectionState == Closed);
 
@@ -125,6 +131,13 @@ namespace mssql
 
 		auto ret = open_timeout(timeout);
 		if (!CheckOdbcError(ret)) return false;
+		// bulk copy must be enabled before connecting; a driver without it still connects.
+		SQLSetConnectAttr(*connection, SQL_COPT_SS_BCP, reinterpret_cast<SQLPOINTER>(SQL_BCP_ON), SQL_IS_INTEGER);
+		if (mars)
+		{
+			ret = SQLSetConnectAttr(*connection, SQL_COPT_SS_MARS_ENABLED, reinterpret_cast<SQLPOINTER>(SQL_MARS_ENABLED_YES), SQL_IS_UINTEGER);
+			if (!CheckOdbcError(ret)) return false;
+		}
 		auto * conn_str = const_cast<wchar_t *>(connection_string.c_str());
 		const auto len = static_cast<SQLSMALLINT>(connection_string.length());
 		ret = SQLDriverConnect(*connection, nullptr, conn_str, len, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
@@ -142,6 +155,262 @@ namespace mssql
 		return CheckOdbcError(ret);
 	}
 	
+	// SQL_ATTR_CONNECTION_DEAD reports what the driver last saw of the connection without a
+	// round trip to the server, so it is cheap enough to ask before every pooled use.
+
+	bool OdbcConnection::try_is_alive(bool & alive)
+	{
+		alive = false;
+		if (connectionState != Open) return true;
+		SQLUINTEGER dead = SQL_CD_TRUE;
+		const auto ret = SQLGetConnectAttr(*connection, SQL_ATTR_CONNECTION_DEAD, &dead, SQL_IS_UINTEGER, nullptr);
+		if (!CheckOdbcError(ret)) return false;
+		alive = dead == SQL_CD_FALSE;
+		return true;
+	}
+
+	// a failed bulk copy leaves the connection open, unlike a failed open.
+
+	bool OdbcConnection::bcp_error()
+	{
+		error = connection->read_errors();
+		bcp_done(*connection);
+		return false;
+	}
+
+	struct bcp_column
+	{
+		INT type;
+		DBINT width;	// bytes passed per value, or 0 when taken from the indicator
+		SQLLEN stride;
+		const char * data;
+		const SQLLEN * ind;
+	};
+
+	static bool bcp_column_type(const shared_ptr<BoundDatum> & datum, bcp_column & col)
+	{
+		col.width = 0;
+		col.stride = datum->buffer_len;
+		switch (datum->c_type)
+		{
+		case SQL_C_BIT:
+			col.type = SQLBIT;
+			col.width = 1;
+			break;
+		case SQL_C_STINYINT:
+		case SQL_C_UTINYINT:
+			col.type = SQLINT1;
+			col.width = 1;
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_USHORT:
+			col.type = SQLINT2;
+			col.width = 2;
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_ULONG:
+			col.type = SQLINT4;
+			col.width = 4;
+			break;
+		case SQL_C_SBIGINT:
+			col.type = SQLINT8;
+			col.width = 8;
+			break;
+		case SQL_C_DOUBLE:
+			col.type = SQLFLT8;
+			col.width = 8;
+			break;
+		case SQL_C_NUMERIC:
+			col.type = SQLNUMERICN;
+			col.width = sizeof(SQL_NUMERIC_STRUCT);
+			break;
+		case SQL_C_TYPE_DATE:
+			col.type = SQLDATEN;
+			col.width = sizeof(SQL_DATE_STRUCT);
+			break;
+		case SQL_C_TIMESTAMP:
+		case SQL_C_TYPE_TIMESTAMP:
+			col.type = SQLDATETIME2N;
+			col.width = sizeof(SQL_TIMESTAMP_STRUCT);
+			break;
+		case SQL_C_CHAR:
+			col.type = SQLCHARACTER;
+			break;
+		case SQL_C_WCHAR:
+			col.type = SQLNCHAR;
+			break;
+		case SQL_C_BINARY:
+			if (datum->sql_type == SQL_SS_TIME2) {
+				col.type = SQLTIMEN;
+				col.width = sizeof(SQL_SS_TIME2_STRUCT);
+			} else if (datum->sql_type == SQL_SS_TIMESTAMPOFFSET) {
+				col.type = SQLDATETIMEOFFSETN;
+				col.width = sizeof(SQL_SS_TIMESTAMPOFFSET_STRUCT);
+			} else {
+				col.type = SQLBINARY;
+			}
+			break;
+		default:
+			return false;
+		}
+		if (col.width > 0) col.stride = col.width;
+		col.data = static_cast<const char*>(datum->buffer);
+		col.ind = datum->get_ind_vec().data();
+		return true;
+	}
+
+	static INT ordinal_of(const BcpOptions & options, const size_t i)
+	{
+		return i < options.ordinals.size() ? options.ordinals[i] : static_cast<INT>(i + 1);
+	}
+
+	// each bound column is an array of values for one table column, in table order.
+	// the driver reads every row straight from the bound arrays via bcp_colptr.
+
+	bool OdbcConnection::try_bcp(const BcpOptions & options, const shared_ptr<BoundDatumSet> & columns, SQLLEN & copied)
+	{
+		copied = 0;
+		if (columns->size() == 0) return true;
+		if (columns->row_size() > 0) {
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] bulk copy does not accept packed rows", -1);
+			return false;
+		}
+
+		vector<bcp_column> cols(columns->size());
+		const auto rows = static_cast<SQLLEN>(columns->atIndex(0)->get_ind_vec().size());
+		for (size_t i = 0; i < cols.size(); ++i)
+		{
+			const auto & datum = columns->atIndex(static_cast<int>(i));
+			if (!bcp_column_type(datum, cols[i]) || static_cast<SQLLEN>(datum->get_ind_vec().size()) != rows) {
+				error = make_shared<OdbcError>("IMNOD", "[msnodesql] bulk copy column cannot be bound", -1);
+				return false;
+			}
+		}
+
+		auto & hdbc = *connection;
+		if (!bcp_begin(options)) return false;
+
+		for (size_t i = 0; i < cols.size(); ++i)
+		{
+			const auto & col = cols[i];
+			const auto len = col.width > 0 ? col.width : SQL_VARLEN_DATA;
+			const auto ordinal = ordinal_of(options, i);
+			if (bcp_bind(hdbc, reinterpret_cast<LPCBYTE>(col.data), 0, len, nullptr, 0, col.type, ordinal) == FAIL) return bcp_error();
+		}
+
+		const auto batch = options.batch_size > 0 ? options.batch_size : 0;
+		for (SQLLEN r = 0; r < rows; ++r)
+		{
+			for (size_t i = 0; i < cols.size(); ++i)
+			{
+				const auto & col = cols[i];
+				const auto ordinal = ordinal_of(options, i);
+				const auto ind = col.ind[r];
+				const auto len = ind == SQL_NULL_DATA ? SQL_NULL_DATA : col.width > 0 ? col.width : static_cast<DBINT>(ind);
+				if (bcp_colptr(hdbc, reinterpret_cast<LPCBYTE>(col.data + r * col.stride), ordinal) == FAIL) return bcp_error();
+				if (bcp_collen(hdbc, len, ordinal) == FAIL) return bcp_error();
+			}
+			if (bcp_sendrow(hdbc) == FAIL) return bcp_error();
+			if (batch > 0 && (r + 1) % batch == 0) {
+				const auto sent = bcp_batch(hdbc);
+				if (sent < 0) return bcp_error();
+				copied += sent;
+			}
+		}
+
+		return bcp_end(copied);
+	}
+
+	bool OdbcConnection::bcp_begin(const BcpOptions & options)
+	{
+		auto & hdbc = *connection;
+		if (bcp_initW(hdbc, options.table_name.c_str(), nullptr, nullptr, DB_IN) == FAIL) return bcp_error();
+		if (!options.hints.empty()) {
+			if (bcp_control(hdbc, BCPHINTSW, const_cast<wchar_t*>(options.hints.c_str())) == FAIL) return bcp_error();
+		}
+		if (options.keep_identity) {
+			if (bcp_control(hdbc, BCPKEEPIDENTITY, reinterpret_cast<void*>(TRUE)) == FAIL) return bcp_error();
+		}
+		return true;
+	}
+
+	bool OdbcConnection::bcp_end(SQLLEN & copied)
+	{
+		const auto sent = bcp_done(*connection);
+		if (sent < 0) {
+			error = connection->read_errors();
+			return false;
+		}
+		copied += sent;
+		return true;
+	}
+
+	// rows are scanned from a delimited utf8 file and sent as utf16 text, which the driver
+	// converts to each column type. ordinals map each file field to a server column, 0 skips
+	// it. an empty unquoted field is sent as null, a quoted one as an empty string.
+
+	bool OdbcConnection::try_bcp_file(const BcpOptions & options, SQLLEN & copied)
+	{
+		copied = 0;
+		CsvReader reader(options.delimiter, options.quote);
+		if (!reader.open(options.file_name)) {
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] cannot open file for import", -1);
+			return false;
+		}
+
+		auto & hdbc = *connection;
+		if (!bcp_begin(options)) return false;
+
+		static const wchar_t empty = 0;
+		const auto empty_ptr = reinterpret_cast<LPCBYTE>(&empty);
+		const auto & ordinals = options.ordinals;
+		for (const auto ordinal : ordinals)
+		{
+			if (ordinal <= 0) continue;
+			if (bcp_bind(hdbc, empty_ptr, 0, SQL_VARLEN_DATA, nullptr, 0, SQLNCHAR, ordinal) == FAIL) return bcp_error();
+		}
+
+		vector<CsvField> fields;
+		vector<vector<wchar_t>> wide(ordinals.size());
+		if (options.header) reader.next(fields);
+		const auto batch = options.batch_size > 0 ? options.batch_size : 0;
+		SQLLEN rows = 0;
+		while (reader.next(fields))
+		{
+			for (size_t i = 0; i < ordinals.size(); ++i)
+			{
+				const auto ordinal = ordinals[i];
+				if (ordinal <= 0) continue;
+				auto ptr = empty_ptr;
+				DBINT len = SQL_NULL_DATA;
+				if (i < fields.size() && (fields[i].len > 0 || fields[i].quoted)) {
+					const auto & field = fields[i];
+					auto & w = wide[i];
+					w.resize(field.len + 1);
+					const auto chars = field.len == 0 ? 0 : MultiByteToWideChar(CP_UTF8, 0, field.data, static_cast<int>(field.len), w.data(), static_cast<int>(w.size()));
+					ptr = reinterpret_cast<LPCBYTE>(w.data());
+					len = static_cast<DBINT>(chars * sizeof(wchar_t));
+				}
+				if (bcp_colptr(hdbc, ptr, ordinal) == FAIL) return bcp_error();
+				if (bcp_collen(hdbc, len, ordinal) == FAIL) return bcp_error();
+			}
+			if (bcp_sendrow(hdbc) == FAIL) return bcp_error();
+			++rows;
+			if (batch > 0 && rows % batch == 0) {
+				const auto sent = bcp_batch(hdbc);
+				if (sent < 0) return bcp_error();
+				copied += sent;
+			}
+		}
+
+		if (reader.failed()) {
+			bcp_done(hdbc);
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] error reading file for import", -1);
+			return false;
+		}
+		return bcp_end(copied);
+	}
+
 	void OdbcConnection::send(const shared_ptr<OdbcOperation> &op) const
 	{
 		//fprintf(stderr, "OdbcConnection send\n");
@@ -31,6 +31,31 @@ namespace mssql
 	class ResultSet;
 	class OdbcOperation;
 	class OperationManager;
+	class BoundDatumSet;
+
+	struct BcpOptions
+	{
+		wstring table_name;
+		wstring hints;
+		int batch_size;
+		bool keep_identity;
+		vector<int> ordinals;	// server column for each bound column, or file field when importing
+		wstring file_name;
+		char delimiter;
+		char quote;
+		bool header;
+	};
+
+	// accumulated over the life of the connection: parameter binding on the node thread
+	// and odbc execution on the background thread.
+
+	struct OperationTimings
+	{
+		int64_t operations = 0;
+		int64_t bind_micros = 0;
+		int64_t execute_micros = 0;
+		int64_t bound_bytes = 0;
+	};
 
 	class OdbcConnection
 	{
@@ -39,13 +64,17 @@ namespace mssql
 		~OdbcConnection();
 		static bool InitializeEnvironment();
 		bool try_begin_tran();
+		bool try_is_alive(bool & alive);
 		void send(const shared_ptr<OdbcOperation> & op) const;
 		bool try_end_tran(SQLSMALLINT completionType);
-		bool try_open(const wstring& connectionString, int timeout);
+		bool try_open(const wstring& connectionString, int timeout, bool mars);
+		bool try_bcp(const BcpOptions & options, const shared_ptr<BoundDatumSet> & columns, SQLLEN & copied);
+		bool try_bcp_file(const BcpOptions & options, SQLLEN & copied);
 		shared_ptr<OdbcError> LastError(void) const { return error; }
 		bool TryClose();
 		shared_ptr<OdbcStatementCache> statements;
 		shared_ptr<OperationManager> ops;
+		OperationTimings timings;
 
 	private:
 		bool ReturnOdbcError();
@@ -53,6 +82,9 @@ namespace mssql
 		
 		static OdbcEnvironmentHandle environment;
 		SQLRETURN open_timeout(int timeout);
+		bool bcp_error();
+		bool bcp_begin(const BcpOptions & options);
+		bool bcp_end(SQLLEN & copied);
 		
 		shared_ptr<OdbcConnectionHandle> connection;
 		CriticalSection closeCriticalSection;
@@ -37,6 +37,12 @@
 #include <UnbindOperation.h>
 #include <OdbcStatementCache.h>
 #include <PollingModeOperation.h>
+#include <PutTvpRowsOperation.h>
+#include <BcpOperation.h>
+#include <ExportOperation.h>
+#include <ReadAllOperation.h>
+#include <IsAliveOperation.h>
+#include <WorkerPool.h>
 
 namespace mssql
 {
@@ -76,6 +82,14 @@ namespace mssql
 		return fact.null();
 	}
 
+	Handle<Value> OdbcConnectionBridge::is_alive(Handle<Object> callback)
+	{
+		const auto op = make_shared<IsAliveOperation>(connection, callback);
+		connection->send(op);
+		nodeTypeFactory fact;
+		return fact.null();
+	}
+
 	Handle<Value> OdbcConnectionBridge::commit(Handle<Object> callback)
 	{
 		const auto op = make_shared<EndTranOperation>(connection, SQL_COMMIT, callback);
@@ -95,6 +109,7 @@ namespace mssql
 	Handle<Value> OdbcConnectionBridge::query(Handle<Number> query_id, Handle<Object> query_object, Handle<Array> params, Handle<Object> callback) const
 	{
 		auto q = make_shared<QueryOperationParams>(query_id, query_object);
+		tag_statement(query_id, query_object);
 		const auto operation = make_shared<QueryOperation>(connection, q, callback);
 		if (operation->bind_parameters(params)) {
 			connection->send(operation);
@@ -103,6 +118,18 @@ namespace mssql
 		return fact.null();
 	}
 
+	Handle<Value> OdbcConnectionBridge::query_all(Handle<Number> query_id, Handle<Object> query_object, Handle<Array> params, Handle<Object> options, Handle<Object> callback) const
+	{
+		auto q = make_shared<QueryOperationParams>(query_id, query_object);
+		tag_statement(query_id, query_object);
+		const auto operation = make_shared<ReadAllOperation>(connection, q, options, callback);
+		if (operation->bind_parameters(params)) {
+			connection->send(operation);
+		}
+		nodeTypeFactory fact;
+		return fact.null();
+	}
+
 	Handle<Value> OdbcConnectionBridge::query_prepared(const Handle<Number> query_id, Handle<Array> params, Handle<Object> callback) const
 	{
 		auto id = query_id->IntegerValue();
@@ -117,6 +144,7 @@ namespace mssql
 	Handle<Value> OdbcConnectionBridge::prepare(Handle<Number> query_id, Handle<Object> query_object, Handle<Object> callback) const
 	{
 		auto q = make_shared<QueryOperationParams>(query_id, query_object);
+		tag_statement(query_id, query_object);
 		const auto operation = make_shared<PrepareOperation>(connection, q, callback);
 		connection->send(operation);
 		nodeTypeFactory fact;
@@ -126,6 +154,7 @@ namespace mssql
 	Handle<Value> OdbcConnectionBridge::call_procedure(Handle<Number> query_id, Handle<Object> query_object, Handle<Array> params, Handle<Object> callback) const
 	{
 		auto q = make_shared<QueryOperationParams>(query_id, query_object);
+		tag_statement(query_id, query_object);
 
 		const auto operation = make_shared<ProcedureOperation>(connection, q, callback);
 		if (operation->bind_parameters(params)) {
@@ -135,6 +164,36 @@ namespace mssql
 		return fact.newInt64(operation->OperationID);
 	}
 
+	Handle<Value> OdbcConnectionBridge::put_tvp_rows(const Handle<Number> query_id, Handle<Array> params, const Handle<Number> rows, Handle<Object> callback) const
+	{
+		auto id = query_id->IntegerValue();
+		const auto operation = make_shared<PutTvpRowsOperation>(connection, id, rows->IntegerValue(), callback);
+		if (operation->bind_parameters(params)) {
+			connection->send(operation);
+		}
+		nodeTypeFactory fact;
+		return fact.null();
+	}
+
+	Handle<Value> OdbcConnectionBridge::bulk_copy(Handle<Object> bcp_object, Handle<Array> params, Handle<Object> callback) const
+	{
+		const auto operation = make_shared<BcpOperation>(connection, bcp_object, callback);
+		if (operation->bind_parameters(params)) {
+			connection->send(operation);
+		}
+		nodeTypeFactory fact;
+		return fact.null();
+	}
+
+	Handle<Value> OdbcConnectionBridge::export_rows(const Handle<Number> query_id, Handle<Object> export_object, Handle<Object> callback) const
+	{
+		auto id = query_id->IntegerValue();
+		const auto operation = make_shared<ExportOperation>(connection, id, export_object, callback);
+		connection->send(operation);
+		nodeTypeFactory fact;
+		return fact.null();
+	}
+
 	Handle<Value> OdbcConnectionBridge::unbind_parameters(const Handle<Number> query_id, Handle<Object> callback)
 	{
 		auto id = query_id->IntegerValue();
@@ -171,12 +230,25 @@ namespace mssql
 		nodeTypeFactory fact;
 		auto op = make_shared<FreeStatementOperation>(connection, id, callback);
 		connection->statements->checkin(id);	
+		connection->ops->untag_statement(id);
 		op->mgr = connection->ops;
 		connection->ops->add(op);
 
 		return fact.null();
 	}
 
+	Handle<Value> OdbcConnectionBridge::timings() const
+	{
+		nodeTypeFactory fact;
+		const auto & t = connection->timings;
+		auto o = fact.newObject();
+		o->Set(fact.newString("operations"), fact.newInt64(t.operations));
+		o->Set(fact.newString("bindMicros"), fact.newInt64(t.bind_micros));
+		o->Set(fact.newString("executeMicros"), fact.newInt64(t.execute_micros));
+		o->Set(fact.newString("boundBytes"), fact.newInt64(t.bound_bytes));
+		return o;
+	}
+
 	Handle<Value> OdbcConnectionBridge::read_row(const Handle<Number> query_id, Handle<Object> callback) const
 	{
 		auto id = query_id->IntegerValue();
@@ -186,10 +258,18 @@ namespace mssql
 		return fact.null();
 	}
 
-	Handle<Value> OdbcConnectionBridge::read_next_result(const Handle<Number> query_id, Handle<Object> callback) const
+	Handle<Value> OdbcConnectionBridge::read_next_result(const Handle<Number> query_id, Handle<Object> callback, const Handle<Value> finish) const
 	{
 		auto id = query_id->IntegerValue();
-		const auto op = make_shared<ReadNextResultOperation>(connection, id, callback);
+		auto free_statement = false;
+		auto unbind = false;
+		if (finish->IsObject())
+		{
+			const auto f = finish.As<Object>();
+			free_statement = get(f, "free")->BooleanValue();
+			unbind = get(f, "unbind")->BooleanValue();
+		}
+		const auto op = make_shared<ReadNextResultOperation>(connection, id, callback, free_statement, unbind);
 		connection->send(op);
 		nodeTypeFactory fact;
 		return fact.null();
@@ -212,11 +292,38 @@ namespace mssql
 		return val;
 	}
 
+	// the priority class and tenant named on a query or connect object, over those in tag.
+	// false when neither is given.
+
+	bool OdbcConnectionBridge::schedule_tag(Local<Object> o, const char * priority, const char * tenant, ScheduleTag & tag)
+	{
+		const auto p = get(o, priority);
+		const auto t = get(o, tenant);
+		if (!p->IsString() && !t->IsString()) return false;
+		if (p->IsString()) tag.klass = WorkerPool::class_index(FromV8String(p->ToString()));
+		if (t->IsString()) tag.flow = hash<wstring>()(FromV8String(t->ToString()));
+		return true;
+	}
+
+	void OdbcConnectionBridge::tag_statement(const Handle<Number> query_id, const Handle<Object> query_object) const
+	{
+		auto tag = connection->ops->connection_tag();
+		if (schedule_tag(query_object, "query_priority", "query_tenant", tag)) {
+			connection->ops->tag_statement(static_cast<long>(query_id->IntegerValue()), tag);
+		}
+	}
+
 	Handle<Value> OdbcConnectionBridge::open(const Handle<Object> connection_object, Handle<Object> callback, Handle<Object> backpointer)
 	{
 		const auto connection_string = get(connection_object, "conn_str")->ToString();
 		auto timeout = get(connection_object, "conn_timeout")->Int32Value();
-		auto op = make_shared<OpenOperation>(connection, FromV8String(connection_string), timeout, callback, backpointer);
+		const auto mars = get(connection_object, "mars")->BooleanValue();
+		connection->ops->spread_statements(mars);
+		ScheduleTag tag;
+		if (schedule_tag(connection_object, "priority", "tenant", tag)) {
+			connection->ops->tag_connection(tag);
+		}
+		auto op = make_shared<OpenOperation>(connection, FromV8String(connection_string), timeout, mars, callback, backpointer);
 		op->mgr = connection->ops;
 		connection->ops->add(op);
 		nodeTypeFactory fact;
@@ -27,6 +27,7 @@ namespace mssql
 	using namespace v8;
 
 	class OdbcConnection;
+	struct ScheduleTag;
 
 	class OdbcConnectionBridge
 	{
@@ -37,23 +38,31 @@ namespace mssql
 		Handle<Value> close(Handle<Object> callback);
 		void collect(void);
 		Handle<Value> begin_transaction(Handle<Object> callback);
+		Handle<Value> is_alive(Handle<Object> callback);
 		Handle<Value> commit(Handle<Object> callback);
 		Handle<Value> rollback(Handle<Object> callback);
 		Handle<Value> query(Handle<Number> queryId, Handle<Object> queryObject, Handle<Array> params, Handle<Object> callback) const;
+		Handle<Value> query_all(Handle<Number> queryId, Handle<Object> queryObject, Handle<Array> params, Handle<Object> options, Handle<Object> callback) const;
 		Handle<Value> query_prepared(Handle<Number> queryId, Handle<Array> params, Handle<Object> callback) const;
 		Handle<Value> prepare(Handle<Number> queryId, Handle<Object> queryObject, Handle<Object> callback) const;
 		Handle<Value> call_procedure(Handle<Number> queryId, Handle<Object> queryObject, Handle<Array> params, Handle<Object> callback) const;
+		Handle<Value> put_tvp_rows(Handle<Number> queryId, Handle<Array> params, Handle<Number> rows, Handle<Object> callback) const;
+		Handle<Value> bulk_copy(Handle<Object> bcpObject, Handle<Array> params, Handle<Object> callback) const;
+		Handle<Value> export_rows(Handle<Number> queryId, Handle<Object> exportObject, Handle<Object> callback) const;
 		Handle<Value> unbind_parameters(Handle<Number> queryId, Handle<Object> callback);
 		Handle<Value> cancel(Handle<Number> queryId, Handle<Object> callback);
 		Handle<Value> polling_mode(Handle<Number> queryId, Handle<Boolean> mode, Handle<Object> callback);
 		Handle<Value> read_row(Handle<Number> queryId, Handle<Object> callback) const;
-		Handle<Value> read_next_result(Handle<Number> queryId, Handle<Object> callback) const;
+		Handle<Value> read_next_result(Handle<Number> queryId, Handle<Object> callback, Handle<Value> finish) const;
 		Handle<Value> read_column(Handle<Number> queryId, Handle<Number> column, Handle<Object> callback) const;	
 		Handle<Value> open(Handle<Object> connectionObject, Handle<Object> callback, Handle<Object> backpointer);
 		Handle<Value> free_statement(Handle<Number> queryId, Handle<Object> callback);
+		Handle<Value> timings() const;
 
 	private:
+		void tag_statement(Handle<Number> query_id, Handle<Object> query_object) const;
 		shared_ptr<OdbcConnection> connection;		
 		static Local<Value> get(Local<Object> o, const char *v);
+		static bool schedule_tag(Local<Object> o, const char * priority, const char * tenant, ScheduleTag & tag);
 	};
 }
@@ -18,10 +18,12 @@
 //---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
+#include <chrono>
 #include <OdbcOperation.h>
 #include <OdbcConnection.h>
 #include <OdbcStatement.h>
 #include <OdbcStatementCache.h>
+#include <BoundDatumSet.h>
 
 namespace mssql
 {
@@ -32,7 +34,8 @@ namespace mssql
 		_callback(Isolate::GetCurrent(), cb.As<Function>()),
 		_cb(cb),
 		failed(false),
-		failure(nullptr)
+		failure(nullptr),
+		_execute_micros(0)
 	{
 		_statementId = static_cast<long>(query_id);
 		nodeTypeFactory fact;
@@ -46,7 +49,8 @@ namespace mssql
 		_callback(Isolate::GetCurrent(), cb.As<Function>()),
 		_cb(cb),
 		failed(false),
-		failure(nullptr)
+		failure(nullptr),
+		_execute_micros(0)
 	{
 		_statementId = static_cast<long>(query_id);
 		nodeTypeFactory fact;
@@ -60,7 +64,8 @@ namespace mssql
 		_callback(Isolate::GetCurrent(), cb.As<Function>()),
 		_cb(cb),
 		failed(false),
-		failure(nullptr)
+		failure(nullptr),
+		_execute_micros(0)
 	{
 		_statementId = -1;
 		nodeTypeFactory fact;
@@ -93,13 +98,21 @@ namespace mssql
 
 	void OdbcOperation::invoke_background()
 	{
+		const auto start = chrono::steady_clock::now();
 		failed = !TryInvokeOdbc();
+		_execute_micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
 
 		if (failed) {
 			getFailure();
 		}
 	}
 
+	void OdbcOperation::reject(const char * message)
+	{
+		failed = true;
+		failure = make_shared<OdbcError>("IMNOD", message, -1);
+	}
+
 	int OdbcOperation::Error(Local<Value> args[])
 	{
 		nodeTypeFactory fact;
@@ -141,11 +154,28 @@ namespace mssql
 		return argc;
 	}
 
+	// totals are only touched on the node thread, as each operation completes.
+
+	void OdbcOperation::record_timings() const
+	{
+		if (!_connection) return;
+		auto & timings = _connection->timings;
+		timings.operations++;
+		timings.execute_micros += _execute_micros;
+		const auto params = bound_params();
+		if (params)
+		{
+			timings.bind_micros += params->bind_micros();
+			timings.bound_bytes += params->bound_bytes();
+		}
+	}
+
 	void OdbcOperation::complete_foreground()
 	{
 		auto isolate = Isolate::GetCurrent();
 		HandleScope scope(isolate);
 		nodeTypeFactory fact;
+		record_timings();
 		if (_callback.IsEmpty()) return;
 		Local<Value> args[3];
 		const auto argc = failed ? Error(args) : Success(args);
@@ -28,6 +28,7 @@ namespace mssql
 
 	class OdbcConnection;
 	class OdbcStatement;
+	class BoundDatumSet;
 
 	class OdbcOperation : public Operation
 	{
@@ -43,10 +44,15 @@ namespace mssql
 		void fetch_statement();
 		long _statementId;
 
+		// parameters bound by this operation, if any, counted in the connection timings.
+		virtual shared_ptr<BoundDatumSet> bound_params() const { return nullptr; }
+
 	private:
 
 		bool failed;
 		shared_ptr<OdbcError> failure;
+		int64_t _execute_micros;
+		void record_timings() const;
 
 	public:
 
@@ -60,9 +66,11 @@ namespace mssql
 
 		void getFailure();
 		void invoke_background() override;
+		void reject(const char * message) override;
 		int Error(Local<Value> args[]);
 		int Success(Local<Value> args[]);
 		void complete_foreground() override;
+		long statement_key() const override { return _statementId; }
 	};
 }
 
@@ -24,6 +24,7 @@
 #include <NodeColumns.h>
 #include <OdbcHelper.h>
 #include <QueryOperationParams.h>
+#include <RowExporter.h>
 
 namespace mssql
 {
@@ -49,6 +50,14 @@ namespace mssql
 		//if (statement) {
 		//	statement->Free();
 		//}
+		if (_asyncEvent != nullptr)
+		{
+			if (_asyncNotify)
+			{
+				SQLSetStmtAttr(*_statement, SQL_ATTR_ASYNC_STMT_EVENT, nullptr, 0);
+			}
+			CloseHandle(_asyncEvent);
+		}
 		_statementState = STATEMENT_CLOSED;
 	}
 
@@ -61,6 +70,13 @@ namespace mssql
 		_prepared(false),
 		_cancelRequested(false),
 		_pollingEnabled(false),
+		_rowBound(false),
+		_asyncEvent(nullptr),
+		_asyncNotify(false),
+		_tvpStreamParam(0),
+		_exportedRows(0),
+		_exportEnd(false),
+		_drainTruncated(false),
 		resultset(nullptr),
 		boundParamsSet(nullptr)
 	{
@@ -83,20 +99,48 @@ namespace mssql
 		SQLSetDescField(hdesc, current_param, SQL_DESC_DATA_PTR, static_cast<SQLPOINTER>(datum->buffer), 0);
 	}
 
-	// this will show on a different thread to the current executing query.
+	// this will show on a different thread to the current executing query. odbc allows the
+	// handle to be cancelled while another thread executes on it, polling or not. the request
+	// is also held, so an execution not yet started fails at once rather than running.
 	bool OdbcStatement::cancel()
 	{
 		lock_guard<mutex> lock(g_i_mutex);
-		if (_pollingEnabled)
-		{
-			_cancelRequested = true;
-			return true;
-		}
+		_cancelRequested = true;
+		const auto& hnd = *_statement;
+		SQLCancelHandle(hnd.HandleType, hnd.get());
+		return true;
+	}
+
+	// a held cancel request is taken, failing the execution or read about to start.
+	bool OdbcStatement::take_cancel()
+	{
+		lock_guard<mutex> lock(g_i_mutex);
+		if (!_cancelRequested) return false;
+		_cancelRequested = false;
 		SQLINTEGER native_error = -1;
 		auto c_state = "CANCEL";
-		auto c_msg = "Error: [msnodesql] cancel only supported for statements where polling is enabled.";
+		auto c_msg = "Error: [msnodesql] Operation canceled.";
 		error = make_shared<OdbcError>(c_state, c_msg, native_error);
-		return false;
+		return true;
+	}
+
+	// a cancel that arrived during execution has been acted on and must not carry over.
+	void OdbcStatement::clear_cancel()
+	{
+		lock_guard<mutex> lock(g_i_mutex);
+		_cancelRequested = false;
+	}
+
+	// a cancel arriving once the statement has executed, while its rows are fetched, ends
+	// the read with the cancel error rather than being left for the next execution.
+	bool OdbcStatement::cancelled_while_reading()
+	{
+		if (!take_cancel()) return false;
+		SQLCancel(*_statement);
+		resultset->endOfRows = true;
+		_endOfResults = true;
+		_statementState = STATEMENT_ERROR;
+		return true;
 	}
 
 	bool OdbcStatement::set_polling(const bool mode)
@@ -139,7 +183,7 @@ namespace mssql
 		const auto& statement = *_statement;
 		const auto r = SQLBindParameter(statement, current_param, datum->param_type, datum->c_type, datum->sql_type,
 		                                datum->param_size, datum->digits, datum->buffer, datum->buffer_len,
-		                                datum->get_ind_vec().data());
+		                                datum->get_ind_ptr());
 		if (!check_odbc_error(r)) return false;
 		if (datum->get_defined_precision())
 		{
@@ -188,9 +232,18 @@ namespace mssql
 	{
 		auto& ps = *params;
 		//fprintf(stderr, "BindParams\n");
-		const auto size = get_size(ps);
+		const auto row_size = ps.row_size();
+		const auto size = row_size > 0 ? static_cast<size_t>(ps.row_count()) : get_size(ps);
 		if (size <= 0) return true;
 		const auto& statement = *_statement;
+		if (row_size > 0 || _rowBound)
+		{
+			// row wise binding from a packed buffer, else back to column wise for a prepared statement re-used.
+			const auto bind_type = row_size > 0 ? static_cast<SQLULEN>(row_size) : SQL_PARAM_BIND_BY_COLUMN;
+			const auto ret = SQLSetStmtAttr(statement, SQL_ATTR_PARAM_BIND_TYPE, reinterpret_cast<SQLPOINTER>(bind_type), 0);
+			if (!check_odbc_error(ret)) return false;
+			_rowBound = row_size > 0;
+		}
 		if (size > 1)
 		{
 			const auto ret = SQLSetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(size), 0);
@@ -412,44 +465,79 @@ namespace mssql
 		return true;
 	}
 
-	SQLRETURN OdbcStatement::poll_check(SQLRETURN ret, const bool direct)
+	// polling mode executes asynchronously. Where the driver supports it the driver manager
+	// signals an event on completion, so the worker waits without spinning. Otherwise the
+	// call is repeated, sleeping a little longer each time up to max_poll_ms.
+
+	void OdbcStatement::enable_async()
 	{
 		const auto& statement = *_statement;
-
-		if (ret == SQL_STILL_EXECUTING)
+		SQLSetStmtAttr(statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
+		if (_asyncEvent == nullptr)
 		{
-			while (true)
+			_asyncEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+			if (_asyncEvent != nullptr)
 			{
-				if (direct)
-				{
-					ret = SQLExecDirect(statement, reinterpret_cast<SQLWCHAR*>(""), SQL_NTS);
-				}
-				else
-				{
-					ret = SQLExecute(statement);
-				}
+				const auto ret = SQLSetStmtAttr(statement, SQL_ATTR_ASYNC_STMT_EVENT, _asyncEvent, 0);
+				_asyncNotify = SQL_SUCCEEDED(ret);
+			}
+		}
+	}
 
-				bool submit_cancel;
-				if (ret != SQL_STILL_EXECUTING)
-				{
-					break;
-				}
+	bool OdbcStatement::cancel_requested()
+	{
+		lock_guard<mutex> lock(g_i_mutex);
+		return _cancelRequested;
+	}
 
-				Sleep(1); // wait 1 MS			
-				{
-					lock_guard<mutex> lock(g_i_mutex);
-					submit_cancel = _cancelRequested;
-				}
+	static const DWORD cancel_check_ms = 10;
+	static const DWORD max_poll_ms = 16;
 
-				if (submit_cancel)
-				{
-					cancel_handle();
-				}
+	SQLRETURN OdbcStatement::wait_async_event()
+	{
+		while (WaitForSingleObject(_asyncEvent, cancel_check_ms) == WAIT_TIMEOUT)
+		{
+			if (cancel_requested())
+			{
+				cancel_handle();
 			}
 		}
+		auto async_ret = static_cast<SQLRETURN>(SQL_ERROR);
+		const auto ret = SQLCompleteAsync(SQL_HANDLE_STMT, *_statement, &async_ret);
+		return SQL_SUCCEEDED(ret) ? async_ret : ret;
+	}
+
+	SQLRETURN OdbcStatement::complete_async(SQLRETURN ret, const function<SQLRETURN()> & retry)
+	{
+		if (ret != SQL_STILL_EXECUTING) return ret;
+		if (_asyncNotify) return wait_async_event();
+
+		DWORD wait = 0;
+		while (true)
+		{
+			Sleep(wait);
+			wait = wait == 0 ? 1 : min(wait * 2, max_poll_ms);
+			if (cancel_requested())
+			{
+				cancel_handle();
+			}
+			ret = retry();
+			if (ret != SQL_STILL_EXECUTING) break;
+		}
 		return ret;
 	}
 
+	SQLRETURN OdbcStatement::poll_check(const SQLRETURN ret, const bool direct)
+	{
+		const auto& statement = *_statement;
+		return complete_async(ret, [&]()
+		{
+			return direct
+				? SQLExecDirect(statement, reinterpret_cast<SQLWCHAR*>(""), SQL_NTS)
+				: SQLExecute(statement);
+		});
+	}
+
 	bool OdbcStatement::bind_fetch(const shared_ptr<BoundDatumSet> & param_set)
 	{
 		const auto& statement = *_statement;
@@ -465,15 +553,17 @@ namespace mssql
 			// error already set in BindParams
 			return false;
 		}
+		if (take_cancel()) return false;
 		if (polling_mode)
 		{
-			SQLSetStmtAttr(statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
+			enable_async();
 		}
 		auto ret = SQLExecute(statement);
 		if (polling_mode)
 		{
 			ret = poll_check(ret, false);
 		}
+		clear_cancel();
 
 		if (!check_odbc_error(ret)) return false;
 
@@ -522,15 +612,27 @@ namespace mssql
 		_statementState = STATEMENT_SUBMITTED;
 		if (polling_mode)
 		{
-			SQLSetStmtAttr(*_statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
+			enable_async();
 		}
+		if (take_cancel()) return false;
 		ret = SQLExecDirect(*_statement, sql_str, SQL_NTS);
 
 		if (polling_mode)
 		{
 			ret = poll_check(ret, true);
 		}
+		clear_cancel();
+
+		if (ret == SQL_NEED_DATA)
+		{
+			return start_tvp_stream(param_set);
+		}
+
+		return read_execute_result(ret, param_set);
+	}
 
+	bool OdbcStatement::read_execute_result(const SQLRETURN ret, const shared_ptr<BoundDatumSet> &param_set)
+	{
 		if (
 			(ret == SQL_SUCCESS_WITH_INFO) ||
 			(ret != SQL_NO_DATA && !SQL_SUCCEEDED(ret)))
@@ -556,6 +658,254 @@ namespace mssql
 		return start_reading_results();
 	}
 
+	SQLRETURN OdbcStatement::param_data(SQLPOINTER * token)
+	{
+		const auto& statement = *_statement;
+		return complete_async(SQLParamData(statement, token), [&]()
+		{
+			return SQLParamData(statement, token);
+		});
+	}
+
+	// a table value parameter bound data at execution is streamed. The first chunk of rows is
+	// bound with the statement, later chunks are rebound into the parameter as the driver asks
+	// for them, so only one chunk is held natively at a time.
+
+	bool OdbcStatement::start_tvp_stream(const shared_ptr<BoundDatumSet> &param_set)
+	{
+		boundParamsSet = param_set;
+		_tvpStream = nullptr;
+		auto current_param = 1;
+		for (auto itr = param_set->begin(); itr != param_set->end(); ++itr)
+		{
+			const auto& datum = *itr;
+			if (datum->is_tvp && datum->tvp_chunk_rows > 0)
+			{
+				_tvpStream = datum;
+				_tvpStreamParam = current_param;
+				break;
+			}
+			if (datum->is_tvp) itr += datum->tvp_no_cols;
+			++current_param;
+		}
+		if (_tvpStream == nullptr)
+		{
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] statement requested data for an unknown parameter", -1);
+			return abandon_tvp_stream();
+		}
+		return put_tvp_rows(_tvpStream->tvp_chunk_rows, nullptr);
+	}
+
+	// the chunk bound last is read by the driver during SQLParamData, so it is only replaced
+	// by the next once that call has returned.
+
+	bool OdbcStatement::put_tvp_rows(const SQLLEN rows, const shared_ptr<BoundDatumSet> &chunk)
+	{
+		const auto& statement = *_statement;
+		SQLPOINTER token = nullptr;
+		auto ret = param_data(&token);
+		if (ret != SQL_NEED_DATA)
+		{
+			end_tvp_stream();
+			return read_execute_result(ret, boundParamsSet);
+		}
+		if (token != _tvpStream->buffer)
+		{
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] statement requested data for an unknown parameter", -1);
+			return abandon_tvp_stream();
+		}
+		if (chunk != nullptr) _tvpChunk = chunk;
+		if (chunk != nullptr && rows > 0)
+		{
+			// variable row binding, the chunk columns replace those bound for the previous chunk.
+			ret = SQLSetStmtAttr(statement, SQL_SOPT_SS_PARAM_FOCUS, reinterpret_cast<SQLPOINTER>(static_cast<SQLLEN>(_tvpStreamParam)), SQL_IS_INTEGER);
+			if (!check_odbc_error(ret)) return abandon_tvp_stream();
+			auto current_param = 1;
+			for (auto itr = _tvpChunk->begin(); itr != _tvpChunk->end(); ++itr)
+			{
+				if (!bind_datum(current_param++, *itr)) return abandon_tvp_stream();
+			}
+			ret = SQLSetStmtAttr(statement, SQL_SOPT_SS_PARAM_FOCUS, static_cast<SQLPOINTER>(nullptr), SQL_IS_INTEGER);
+			if (!check_odbc_error(ret)) return abandon_tvp_stream();
+		}
+		ret = complete_async(SQLPutData(statement, nullptr, rows), [&]()
+		{
+			return SQLPutData(statement, nullptr, rows);
+		});
+		if (!check_odbc_error(ret)) return abandon_tvp_stream();
+
+		if (rows > 0)
+		{
+			// the driver asks for the next chunk when it is put.
+			resultset = make_unique<ResultSet>(0);
+			resultset->endOfRows = true;
+			return true;
+		}
+
+		ret = param_data(&token);
+		end_tvp_stream();
+		return read_execute_result(ret, boundParamsSet);
+	}
+
+	string * OdbcStatement::export_data() const
+	{
+		return _exporter ? &_exporter->data() : nullptr;
+	}
+
+	// fetch rows of the current result straight into text without building any column
+	// objects, for the caller to take. a result after the one last exported starts afresh
+	// with its own columns.
+
+	bool OdbcStatement::try_export_rows(const ExportOptions & options)
+	{
+		if (resultset == nullptr) return false;
+		if (!_statement) return false;
+		const auto& statement = *_statement;
+
+		if (!_exporter || _exportEnd) {
+			const auto format = options.format == RowExporter::NDJSON ? RowExporter::NDJSON : RowExporter::CSV;
+			_exporter = make_shared<RowExporter>(format, options.delimiter);
+			_exporter->columns(*resultset);
+			_exportEnd = false;
+		}
+
+		if (cancelled_while_reading()) return false;
+		auto & out = _exporter->data();
+		_exportedRows = 0;
+		while (!_exportEnd && out.size() < options.chunk_bytes)
+		{
+			auto ret = complete_async(SQLFetch(statement), [&]()
+			{
+				return SQLFetch(statement);
+			});
+			if (ret == SQL_NO_DATA) {
+				resultset->endOfRows = true;
+				_exportEnd = true;
+				break;
+			}
+			if (!check_odbc_error(ret)) return false;
+			_statementState = STATEMENT_FETCHING;
+			ret = _exporter->append_row(statement);
+			if (!check_odbc_error(ret)) return false;
+			++_exportedRows;
+		}
+		return true;
+	}
+
+	// keep the message for the caller. an info message, sqlstate 01, leaves the statement
+	// readable so draining carries on; anything else ends it.
+
+	bool OdbcStatement::drain_error()
+	{
+		const auto err = get_last_error();
+		if (!err) return false;
+		_drainErrors.push_back(err);
+		error = nullptr;
+		return string(err->SqlState()).compare(0, 2, "01") == 0;
+	}
+
+	// fetch every row of every result once the statement has executed. Column values are
+	// kept natively until the caller converts them all at once. Reading stops, marking the
+	// results truncated, when a further row would pass max_rows or take the bytes read past
+	// max_bytes (0 for no cap); that row is not returned.
+
+	bool OdbcStatement::try_read_all(const bool executed, const size_t max_rows, const size_t max_bytes)
+	{
+		if (!_statement) return false;
+		_drained.clear();
+		_drainErrors.clear();
+		_drainTruncated = false;
+		if (!executed && !drain_error()) return true;
+
+		size_t rows = 0;
+		size_t bytes = 0;
+		while (resultset != nullptr)
+		{
+			const auto drained = make_shared<DrainedResult>(resultset);
+			_drained.push_back(drained);
+			const auto columns = static_cast<int>(resultset->get_column_count());
+			while (columns > 0)
+			{
+				if (!try_read_row())
+				{
+					drain_error();
+					return true;
+				}
+				if (resultset->EndOfRows()) break;
+				if (max_rows > 0 && rows >= max_rows) return truncate_read_all();
+				vector<DrainedResult::cell_t> row;
+				size_t row_bytes = 0;
+				for (auto column = 0; column < columns; ++column)
+				{
+					DrainedResult::cell_t cell;
+					do
+					{
+						if (!try_read_column(column))
+						{
+							drain_error();
+							return true;
+						}
+						cell.push_back(resultset->get_column());
+						row_bytes += cell.back()->Bytes();
+					} while (cell.back()->More());
+					row.push_back(move(cell));
+				}
+				// a row that would take the total past the cap is left out.
+				if (max_bytes > 0 && bytes + row_bytes > max_bytes) return truncate_read_all();
+				bytes += row_bytes;
+				for (auto & cell : row)
+				{
+					drained->cells.push_back(move(cell));
+				}
+				++drained->rows;
+				++rows;
+			}
+			if (!try_read_next_result() && !drain_error()) return true;
+			if (_endOfResults) break;
+		}
+		return true;
+	}
+
+	bool OdbcStatement::truncate_read_all()
+	{
+		_drainTruncated = true;
+		SQLCancel(*_statement);
+		return true;
+	}
+
+	bool OdbcStatement::try_put_tvp_rows(const shared_ptr<BoundDatumSet> &chunk, const SQLLEN rows)
+	{
+		if (_tvpStream == nullptr)
+		{
+			error = make_shared<OdbcError>("IMNOD", "[msnodesql] statement is not waiting for table value rows", -1);
+			return false;
+		}
+		if (rows < 0)
+		{
+			abandon_tvp_stream();
+			resultset = make_unique<ResultSet>(0);
+			resultset->endOfRows = true;
+			return true;
+		}
+		return put_tvp_rows(rows, chunk);
+	}
+
+	bool OdbcStatement::abandon_tvp_stream()
+	{
+		const auto saved_error = error;
+		SQLCancel(*_statement);
+		end_tvp_stream();
+		error = saved_error;
+		return false;
+	}
+
+	void OdbcStatement::end_tvp_stream()
+	{
+		_tvpStream = nullptr;
+		_tvpChunk = nullptr;
+		_tvpStreamParam = 0;
+	}
+
 	bool OdbcStatement::try_read_row()
 	{
 		//column = 0; // reset
@@ -563,6 +913,7 @@ namespace mssql
 
 		if (resultset == nullptr) return false;
 		if (!_statement) return false;
+		if (cancelled_while_reading()) return false;
 		const auto& statement = *_statement;
 
 		const auto ret = SQLFetch(statement);
@@ -1045,8 +1396,10 @@ namespace mssql
 			resultset->endOfRows = true;
 			_endOfResults = true;
 			_statementState = STATEMENT_ERROR;
+			clear_cancel();
 			return false;
 		}
+		if (cancelled_while_reading()) return false;
 
 		const auto ret = SQLMoreResults(*_statement);
 		switch (ret)
@@ -1055,6 +1408,7 @@ namespace mssql
 			{
 				//fprintf(stderr, "SQL_NO_DATA\n");
 				_endOfResults = true;
+				clear_cancel();
 				if (_prepared)
 				{
 					SQLCloseCursor(*_statement);
@@ -28,6 +28,8 @@ namespace mssql
 	class BoundDatumSet;
 	class DatumStorage;
 	class QueryOperationParams;
+	class RowExporter;
+	struct ExportOptions;
 
 
 	using namespace std;
@@ -83,9 +85,27 @@ namespace mssql
 		bool try_read_row();
 		bool try_read_column(int column);
 		bool try_read_next_result();
+		bool try_put_tvp_rows(const shared_ptr<BoundDatumSet> &chunk, SQLLEN rows);
+		bool try_export_rows(const ExportOptions & options);
+		SQLLEN exported_rows() const { return _exportedRows; }
+		bool export_end() const { return _exportEnd; }
+		string * export_data() const;
+		bool try_read_all(bool executed, size_t max_rows, size_t max_bytes);
+		const vector<shared_ptr<DrainedResult>> & drained() const { return _drained; }
+		const vector<shared_ptr<OdbcError>> & drain_errors() const { return _drainErrors; }
+		bool drain_truncated() const { return _drainTruncated; }
 
 	private:
 		SQLRETURN poll_check(SQLRETURN ret, bool direct);
+		void enable_async();
+		SQLRETURN complete_async(SQLRETURN ret, const function<SQLRETURN()> & retry);
+		SQLRETURN wait_async_event();
+		bool cancel_requested();
+		bool take_cancel();
+		bool cancelled_while_reading();
+		void clear_cancel();
+		bool drain_error();
+		bool truncate_read_all();
 		bool get_data_binary(int column);
 		bool get_data_decimal(int column);
 		bool get_data_bit(int column);
@@ -119,6 +139,12 @@ namespace mssql
 		bool bind_params(const shared_ptr<BoundDatumSet> & params);
 		void queue_tvp(int current_param, param_bindings::iterator &itr, shared_ptr<BoundDatum> &datum, vector <tvp_t> & tvps);
 		bool try_read_string(bool binary, int column);
+		bool read_execute_result(SQLRETURN ret, const shared_ptr<BoundDatumSet> &param_set);
+		SQLRETURN param_data(SQLPOINTER * token);
+		bool start_tvp_stream(const shared_ptr<BoundDatumSet> &param_set);
+		bool put_tvp_rows(SQLLEN rows, const shared_ptr<BoundDatumSet> &chunk);
+		bool abandon_tvp_stream();
+		void end_tvp_stream();
 
 		bool return_odbc_error();
 		bool check_odbc_error(SQLRETURN ret);
@@ -139,6 +165,28 @@ namespace mssql
 		bool _prepared;
 		bool _cancelRequested;
 		bool _pollingEnabled;
+		bool _rowBound;
+
+		// signalled by the driver manager when an asynchronous call completes, where the
+		// driver supports odbc 3.8 notification. otherwise calls are polled with backoff.
+		HANDLE _asyncEvent;
+		bool _asyncNotify;
+
+		// a table value parameter streamed data at execution, and the chunk currently bound to it.
+		shared_ptr<BoundDatum> _tvpStream;
+		shared_ptr<BoundDatumSet> _tvpChunk;
+		int _tvpStreamParam;
+
+		// rows fetched straight into csv or ndjson text by try_export_rows.
+		shared_ptr<RowExporter> _exporter;
+		SQLLEN _exportedRows;
+		bool _exportEnd;
+
+		// every result of the statement read in one go by try_read_all, with the info messages
+		// and any error met on the way.
+		vector<shared_ptr<DrainedResult>> _drained;
+		vector<shared_ptr<OdbcError>> _drainErrors;
+		bool _drainTruncated;
 
 		OdbcStatementState _statementState = STATEMENT_CREATED;
 
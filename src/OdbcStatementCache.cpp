@@ -36,6 +36,7 @@ namespace mssql
 
 	void OdbcStatementCache::clear()
 	{
+		lock_guard<mutex> lock(_lock);
 		vector<long> ids;
 		// fprintf(stderr, "destruct OdbcStatementCache\n");
 
@@ -72,6 +73,7 @@ namespace mssql
 			//fprintf(stderr, "dont fetch id %ld\n", statementId);
 			return nullptr;
 		}
+		lock_guard<mutex> lock(_lock);
 		auto statement = find(statement_id);
 		if (statement) return statement;
 		return store(make_shared<OdbcStatement>(statement_id, connection));
@@ -79,6 +81,7 @@ namespace mssql
 
 	void OdbcStatementCache::checkin(const long statement_id)
 	{
+		lock_guard<mutex> lock(_lock);
 		statements.erase(statement_id);
 	}
 }
@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include <map>
+#include <mutex>
 #include <OdbcConnection.h>
 
 namespace mssql
@@ -36,7 +37,11 @@ namespace mssql
 		~OdbcStatementCache();
 		shared_ptr<OdbcStatement> checkout(long statementId);
 		void checkin(long statementId);
-		size_t size() const { return statements.size(); } 
+		size_t size() const
+		{
+			lock_guard<mutex> lock(_lock);
+			return statements.size();
+		}
 		void clear();
 
 	private:
@@ -47,5 +52,8 @@ namespace mssql
 
 		map_statements_t statements;
 		shared_ptr<OdbcConnectionHandle> connection;
+		// statements are checked out on the node thread and on the driver workers, several
+		// of them at once when statements run on workers of their own.
+		mutable mutex _lock;
 	};
 }
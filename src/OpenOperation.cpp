@@ -4,12 +4,13 @@
 
 namespace mssql
 {
-	OpenOperation::OpenOperation(const shared_ptr<OdbcConnection> &connection, const wstring& connection_string, const int timeout, const Handle<Object> callback,
+	OpenOperation::OpenOperation(const shared_ptr<OdbcConnection> &connection, const wstring& connection_string, const int timeout, const bool mars, const Handle<Object> callback,
 	                             const Handle<Object> backpointer)
 		: OdbcOperation(connection, callback),
 		connectionString(connection_string),
 		backpointer(Isolate::GetCurrent(), backpointer),
-		timeout(timeout)
+		timeout(timeout),
+		mars(mars)
 	{
 	}
 
@@ -20,7 +21,7 @@ namespace mssql
 
 	bool OpenOperation::TryInvokeOdbc()
 	{
-		return _connection->try_open(connectionString, timeout);
+		return _connection->try_open(connectionString, timeout, mars);
 	}
 
 	Local<Value> OpenOperation::CreateCompletionArg()
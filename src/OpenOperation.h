@@ -33,10 +33,11 @@ namespace mssql
 		wstring connectionString;
 		Persistent<Object> backpointer;
 		int timeout;
+		bool mars;
 
 	public:
 		OpenOperation(const shared_ptr<OdbcConnection> &connection, const wstring& connectionString,
-			int timeout, Handle<Object> callback, Handle<Object> backpointer);	
+			int timeout, bool mars, Handle<Object> callback, Handle<Object> backpointer);	
 		virtual ~OpenOperation(void);
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
@@ -20,6 +20,7 @@
 #pragma once
 #include <map>
 #include <memory>
+#include <chrono>
 #include <stdafx.h>
 
 namespace mssql {
@@ -27,14 +28,26 @@ namespace mssql {
     using namespace std;
  
 	class OdbcStatement;
+	class OperationManager;
+
+	// where an operation queues on its driver worker: the priority class, and the tenant
+	// flow within that class it takes turns with.
+	struct ScheduleTag
+	{
+		ScheduleTag() : klass(0), flow(0) {}
+		size_t klass;
+		size_t flow;
+	};
 
     class Operation
     {
 	   friend class OperationManager;
 
     public:
+	   static const size_t unassigned = static_cast<size_t>(-1);
+
 	   Operation() :
-		   OperationID(-1)
+		   OperationID(unassigned)
 	   {
 	   }
 
@@ -42,10 +55,18 @@ namespace mssql {
 	   virtual void invoke_background() = 0;
 	   virtual void complete_foreground() = 0;
 
+	   // false for an operation that runs at once rather than queued behind the others on its connection
+	   virtual bool ordered() const { return true; }
+
+	   // the statement an operation works on, or -1 for one on the connection as a whole
+	   virtual long statement_key() const { return -1; }
+
+	   // the operation will not run; it completes with this error instead.
+	   virtual void reject(const char * message) {}
+
 	   size_t OperationID;
 	   shared_ptr<OperationManager> mgr;
-	  
-    private:
-	   uv_work_t  work;	 
+	   ScheduleTag schedule;
+	   chrono::steady_clock::time_point queued_at;
     };
 }
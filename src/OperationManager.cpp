@@ -1,46 +1,158 @@
 #include <Operation.h>
 #include <OperationManager.h>
-#include <mutex>
+#include <WorkerPool.h>
 
 namespace mssql
 {
-	OperationManager::OperationManager() : _id(0)
+	OperationManager::OperationManager() : 
+		_allocated(0),
+		_free(0),
+		_worker(WorkerPool::instance().assign()),
+		_spread(false)
 	{		
+		for (auto & block : _blocks) {
+			block.store(nullptr, memory_order_relaxed);
+		}
 	}
 
 	OperationManager::~OperationManager()
 	{
 	//	fprintf(stderr, "~OperationManager\n");
+		for (auto & block : _blocks) {
+			delete[] block.load(memory_order_acquire);
+		}
+	}
+
+	OperationManager::Slot * OperationManager::slot(const size_t index) const
+	{
+		if (index >= max_blocks * block_size) return nullptr;
+		const auto block = _blocks[index / block_size].load(memory_order_acquire);
+		return block != nullptr ? &block[index % block_size] : nullptr;
+	}
+
+	// where size_t is 32 bits the generation is truncated the same way on both sides.
+
+	size_t OperationManager::make_id(const uint32_t generation, const size_t index)
+	{
+		return static_cast<size_t>(generation) << slot_bits | index;
+	}
+
+	bool OperationManager::matches(const Slot & s, const size_t id)
+	{
+		return make_id(s.generation.load(memory_order_acquire), id & slot_mask) == id;
+	}
+
+	bool OperationManager::acquire(uint32_t & index)
+	{
+		auto head = _free.load(memory_order_acquire);
+		while (static_cast<uint32_t>(head) != 0) {
+			const auto top = static_cast<uint32_t>(head) - 1;
+			const auto next = ((head >> 32) + 1) << 32 | slot(top)->next_free.load(memory_order_relaxed);
+			if (_free.compare_exchange_weak(head, next, memory_order_acq_rel, memory_order_acquire)) {
+				index = top;
+				return true;
+			}
+		}
+
+		// no slot to reuse, carve the next one and allocate its block if this is the first.
+		const auto fresh = _allocated.fetch_add(1, memory_order_relaxed);
+		if (fresh >= max_blocks * block_size) {
+			_allocated.fetch_sub(1, memory_order_relaxed);
+			return false;
+		}
+		auto & block = _blocks[fresh / block_size];
+		if (block.load(memory_order_acquire) == nullptr) {
+			const auto slots = new Slot[block_size];
+			Slot * expected = nullptr;
+			if (!block.compare_exchange_strong(expected, slots, memory_order_acq_rel)) {
+				delete[] slots;
+			}
+		}
+		index = fresh;
+		return true;
+	}
+
+	void OperationManager::release(const uint32_t index)
+	{
+		const auto s = slot(index);
+		s->generation.fetch_add(1, memory_order_acq_rel);
+		s->operation.store(nullptr, memory_order_release);
+
+		auto head = _free.load(memory_order_acquire);
+		uint64_t next;
+		do {
+			s->next_free.store(static_cast<uint32_t>(head), memory_order_relaxed);
+			next = ((head >> 32) + 1) << 32 | (index + 1);
+		} while (!_free.compare_exchange_weak(head, next, memory_order_acq_rel, memory_order_acquire));
 	}
 
 	bool OperationManager::add(shared_ptr<Operation> operation_ptr)
 	{
-		lock_guard<mutex> lock(g_i_mutex);
-		operation_ptr->OperationID = static_cast<int>(++_id);
-		operations.insert(pair<size_t, shared_ptr<Operation>>(operation_ptr->OperationID, operation_ptr));
-		operation_ptr->work.data = operation_ptr.get();
+		auto & pool = WorkerPool::instance();
+		uint32_t index;
+		if (!acquire(index)) {
+			operation_ptr->reject("[msnodesql] too many operations in flight on the connection");
+			pool.reject(operation_ptr);
+			return false;
+		}
+		const auto s = slot(index);
+		s->operation.store(operation_ptr.get(), memory_order_release);
+		const auto generation = s->generation.load(memory_order_acquire);
+		operation_ptr->OperationID = make_id(generation, index);
 
-		const auto result = uv_queue_work(uv_default_loop(), &operation_ptr->work, on_background, reinterpret_cast<uv_after_work_cb>(on_foreground));
-		return result == 0;
+		if (operation_ptr->ordered()) {
+			const auto key = operation_ptr->statement_key();
+			const auto tag = _tags.find(key);
+			operation_ptr->schedule = tag != _tags.end() ? tag->second : _default;
+			const auto affinity = _spread && key >= 0 ? lane_worker(key) : _worker;
+			pool.dispatch(operation_ptr, affinity);
+		}
+		else {
+			pool.run_inline(operation_ptr);
+		}
+		return true;
 	}
 
-	void OperationManager::on_foreground(uv_work_t* work)
+	// a statement given its own worker takes one no other statement of the connection, nor
+	// the connection itself, is queued to. with more statements than workers they share them
+	// in turn.
+
+	size_t OperationManager::lane_worker(const long statement_id)
 	{
-		auto operation = static_cast<Operation*>(work->data);
-		//fprintf(stderr, "OnForeground %llu\n ", operation->OperationID);
-		operation->complete_foreground();
-		operation->mgr->check_in_operation(operation->OperationID);
+		const auto found = _lanes.find(statement_id);
+		if (found != _lanes.end()) return found->second;
+		const auto workers = WorkerPool::size();
+		vector<bool> used(workers, false);
+		used[_worker % workers] = true;
+		for (const auto & lane : _lanes)
+		{
+			used[lane.second] = true;
+		}
+		auto worker = (_worker + 1 + _lanes.size()) % workers;
+		for (size_t i = 1; i < workers; ++i)
+		{
+			const auto w = (_worker + i) % workers;
+			if (used[w]) continue;
+			worker = w;
+			break;
+		}
+		_lanes[statement_id] = worker;
+		return worker;
 	}
 
 	void OperationManager::check_in_operation(const size_t id)
 	{
-		lock_guard<mutex> lock(g_i_mutex);
-		operations.erase(id);
+		if (id == Operation::unassigned) return;
+		const auto s = slot(id & slot_mask);
+		if (s == nullptr || !matches(*s, id)) return;
+		release(static_cast<uint32_t>(id & slot_mask));
 	}
 
-	void OperationManager::on_background(uv_work_t* work)
+	Operation * OperationManager::get_operation(const size_t id) const
 	{
-		auto operation = static_cast<Operation*>(work->data);
-		operation->invoke_background();
+		const auto s = slot(id & slot_mask);
+		if (s == nullptr || !matches(*s, id)) return nullptr;
+		const auto op = s->operation.load(memory_order_acquire);
+		return matches(*s, id) ? op : nullptr;
 	}
 }
\ No newline at end of file
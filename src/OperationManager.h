@@ -18,38 +18,76 @@
 //---------------------------------------------------------------------------------------------------------------------------------
 
 #pragma once
-#include <map>
+#include <atomic>
 #include <memory>
+#include <map>
 #include <stdafx.h>
+#include <Operation.h>
 
 namespace mssql {
 
 	using namespace std;
 
-	class Operation;
-
-	/* need to think about threading with multiple active connections */
+	// in flight operations are held in pre-allocated slots. An id carries the slot index in its
+	// low bits and the slot generation above them, so a stale id for a recycled slot is ignored.
+	// Free slots form a tagged lock-free stack and blocks of slots are never moved or freed
+	// while the manager lives, so lookup and check in take no lock. A slot does not own its
+	// operation, the worker pool holds it until it is checked in.
 
 	class OperationManager
 	{
-		typedef map<size_t, shared_ptr<Operation>> map_operations_t;
+		struct Slot
+		{
+			Slot() : generation(0), next_free(0), operation(nullptr) {}
+			atomic<uint32_t> generation;
+			atomic<uint32_t> next_free;		// index + 1 of the next free slot, 0 at the end
+			atomic<Operation*> operation;
+		};
+
+		static const size_t slot_bits = 16;
+		static const size_t slot_mask = (static_cast<size_t>(1) << slot_bits) - 1;
+		static const size_t block_size = 64;
+		static const size_t max_blocks = (slot_mask + 1) / block_size;
 
 	public:
 		OperationManager();
 		~OperationManager();
+		// false when every slot is in use; the operation is then failed back to its caller.
 		bool add(shared_ptr<Operation> operation_ptr);
 		void check_in_operation(size_t id);
-		shared_ptr<Operation> get_operation(int id)
+		// only valid on the loop thread, where an operation is checked in.
+		Operation * get_operation(size_t id) const;
+		// with multiple active result sets each statement's operations are ordered on a worker
+		// of their own, so one statement's long execute does not hold up the others.
+		void spread_statements(bool spread) { _spread = spread; }
+		// the class and tenant operations queue under: those given for the connection, unless
+		// its statement was given its own. Only touched on the loop thread.
+		void tag_connection(const ScheduleTag & tag) { _default = tag; }
+		const ScheduleTag & connection_tag() const { return _default; }
+		void tag_statement(long statement_id, const ScheduleTag & tag) { _tags[statement_id] = tag; }
+		// once a statement is freed, its tag and the worker its operations were queued to
+		// are given up.
+		void untag_statement(long statement_id)
 		{
-			map_operations_t::const_iterator itr = operations.find(id);
-			return itr->second;
+			_tags.erase(statement_id);
+			_lanes.erase(statement_id);
 		}
 
 	private:
-		map_operations_t operations;
-		ssize_t _id;
-		static void on_background(uv_work_t* work);
-		static void on_foreground(uv_work_t* work);
-		mutex g_i_mutex;
+		static size_t make_id(uint32_t generation, size_t index);
+		static bool matches(const Slot & s, size_t id);
+		Slot * slot(size_t index) const;
+		bool acquire(uint32_t & index);
+		void release(uint32_t index);
+		size_t lane_worker(long statement_id);
+
+		atomic<Slot*> _blocks[max_blocks];
+		atomic<uint32_t> _allocated;	// slots carved from blocks so far
+		atomic<uint64_t> _free;		// aba tag in the high word, index + 1 of the head in the low
+		size_t _worker;		// the driver worker running this connection's operations
+		bool _spread;
+		ScheduleTag _default;
+		map<long, ScheduleTag> _tags;
+		map<long, size_t> _lanes;	// worker each spread statement is queued to, on the loop thread
 	};
 }
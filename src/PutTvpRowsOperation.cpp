@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <OdbcStatement.h>
+#include <PutTvpRowsOperation.h>
+#include <BoundDatumSet.h>
+
+namespace mssql
+{
+	PutTvpRowsOperation::PutTvpRowsOperation(
+		const shared_ptr<OdbcConnection> &connection,
+		const size_t query_id,
+		const SQLLEN rows,
+		const Handle<Object> callback) :
+		OdbcOperation(connection, query_id, callback),
+		_rows(rows)
+	{
+		_params = make_shared<BoundDatumSet>();
+	}
+
+	bool PutTvpRowsOperation::parameter_error_to_user_callback(const uint32_t param, const char* error) const
+	{
+		nodeTypeFactory fact;
+
+		_params->clear();
+
+		stringstream full_error;
+		full_error << "IMNOD: [msnodesql] Table value column " << param + 1 << ": " << error;
+
+		auto err = fact.error(full_error);
+		const auto imn = fact.newString("IMNOD");
+		err->Set(fact.newString("sqlstate"), imn);
+		err->Set(fact.newString("code"), fact.newInteger(-1));
+
+		Local<Value> args[1];
+		args[0] = err;
+		const auto argc = 1;
+
+		fact.scopedCallback(_callback, argc, args);
+
+		return false;
+	}
+
+	bool PutTvpRowsOperation::bind_parameters(Handle<Array> &node_params) const
+	{
+		const auto res = _params->bind(node_params);
+		if (!res)
+		{
+			parameter_error_to_user_callback(_params->first_error, _params->err);
+		}
+
+		return res;
+	}
+
+	bool PutTvpRowsOperation::TryInvokeOdbc()
+	{
+		if (_statement == nullptr) return false;
+		return _statement->try_put_tvp_rows(_params, _rows);
+	}
+
+	Local<Value> PutTvpRowsOperation::CreateCompletionArg()
+	{
+		return _statement->get_meta_value();
+	}
+}
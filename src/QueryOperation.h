@@ -43,6 +43,7 @@ namespace mssql
 		bool ParameterErrorToUserCallback(uint32_t param, const char* error) const;
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		shared_ptr<BoundDatumSet> bound_params() const override { return _params; }
 
 	protected:
 	
@@ -41,6 +41,7 @@ namespace mssql
 		bool parameter_error_to_user_callback(uint32_t param, const char* error) const;
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		shared_ptr<BoundDatumSet> bound_params() const override { return _params; }
 
 	protected:
 	
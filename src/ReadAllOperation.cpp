@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <OdbcStatement.h>
+#include <OdbcStatementCache.h>
+#include <OperationManager.h>
+#include <ReadAllOperation.h>
+#include <QueryOperationParams.h>
+
+namespace mssql
+{
+	static Local<Value> get(Local<Object> o, const char *v)
+	{
+		nodeTypeFactory fact;
+		return o->Get(fact.newString(v));
+	}
+
+	ReadAllOperation::ReadAllOperation(
+		const shared_ptr<OdbcConnection> &connection,
+		const shared_ptr<QueryOperationParams> &query,
+		const Handle<Object> options,
+		const Handle<Object> callback) :
+		QueryOperation(connection, query, callback)
+	{
+		_maxRows = static_cast<size_t>(get(options, "max_rows")->IntegerValue());
+		_maxBytes = static_cast<size_t>(get(options, "max_bytes")->IntegerValue());
+	}
+
+	bool ReadAllOperation::TryInvokeOdbc()
+	{
+		_statement = _connection->statements->checkout(_statementId);
+		_statement->set_polling(_query->polling());
+		const auto executed = _statement->try_execute_direct(_query, _params);
+		return _statement->try_read_all(executed, _maxRows, _maxBytes);
+	}
+
+	// a lob arrives as several pieces, joined here into one string or Buffer.
+
+	Local<Value> ReadAllOperation::cell_value(const vector<shared_ptr<Column>> & pieces)
+	{
+		nodeTypeFactory fact;
+		auto first = fact.newLocalValue(pieces[0]->ToValue());
+		if (pieces.size() == 1) return first;
+		if (first->IsString())
+		{
+			auto s = first.As<String>();
+			for (size_t i = 1; i < pieces.size(); ++i)
+			{
+				s = String::Concat(s, fact.newLocalValue(pieces[i]->ToValue()).As<String>());
+			}
+			return s;
+		}
+		vector<Local<Value>> buffers;
+		size_t total = 0;
+		for (const auto & piece : pieces)
+		{
+			const auto b = fact.newLocalValue(piece->ToValue());
+			total += node::Buffer::Length(b);
+			buffers.push_back(b);
+		}
+		const auto joined = fact.newBuffer(static_cast<int>(total));
+		auto offset = node::Buffer::Data(joined);
+		for (const auto & b : buffers)
+		{
+			memcpy(offset, node::Buffer::Data(b), node::Buffer::Length(b));
+			offset += node::Buffer::Length(b);
+		}
+		return joined;
+	}
+
+	Local<Value> ReadAllOperation::CreateCompletionArg()
+	{
+		nodeTypeFactory fact;
+		const auto & drained = _statement->drained();
+		auto sets = fact.newArray(static_cast<int>(drained.size()));
+		for (size_t i = 0; i < drained.size(); ++i)
+		{
+			const auto & d = *drained[i];
+			const auto columns = d.results->get_column_count();
+			auto rows = fact.newArray(static_cast<int>(d.rows));
+			for (size_t r = 0; r < d.rows; ++r)
+			{
+				auto row = fact.newArray(static_cast<int>(columns));
+				for (size_t c = 0; c < columns; ++c)
+				{
+					row->Set(static_cast<uint32_t>(c), cell_value(d.cells[r * columns + c]));
+				}
+				rows->Set(static_cast<uint32_t>(r), row);
+			}
+			auto set = fact.newObject();
+			set->Set(fact.newString("meta"), d.results->meta_to_value());
+			set->Set(fact.newString("rows"), rows);
+			set->Set(fact.newString("rowcount"), fact.newInt64(d.results->row_count()));
+			sets->Set(static_cast<uint32_t>(i), set);
+		}
+
+		const auto & errors = _statement->drain_errors();
+		auto errs = fact.newArray(static_cast<int>(errors.size()));
+		for (size_t i = 0; i < errors.size(); ++i)
+		{
+			auto err = fact.error(errors[i]->Message());
+			err->Set(fact.newString("sqlstate"), fact.newString(errors[i]->SqlState()));
+			err->Set(fact.newString("code"), fact.newInteger(errors[i]->Code()));
+			errs->Set(static_cast<uint32_t>(i), err);
+		}
+
+		auto o = fact.newObject();
+		o->Set(fact.newString("sets"), sets);
+		o->Set(fact.newString("outputParams"), _statement->unbind_params()->Clone());
+		o->Set(fact.newString("errors"), errs);
+		o->Set(fact.newString("truncated"), fact.newBoolean(_statement->drain_truncated()));
+
+		// nothing more is read, so the statement is freed without another call from js.
+		_connection->statements->checkin(_statementId);
+		mgr->untag_statement(_statementId);
+		return o;
+	}
+}
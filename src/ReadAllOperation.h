@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ReadAllOperation.h
+// Contents: execute a query and read all of its results in one call
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <QueryOperation.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+
+	// executes the query, fetches every result, unbinds output parameters and frees the
+	// statement in a single trip to the driver worker. completes with
+	// { sets: [{ meta, rows, rowcount }], outputParams, errors, truncated }.
+
+	class ReadAllOperation : public QueryOperation
+	{
+	public:
+		ReadAllOperation(
+			const shared_ptr<OdbcConnection> &connection,
+			const shared_ptr<QueryOperationParams> &query,
+			Handle<Object> options,
+			Handle<Object> callback);
+		bool TryInvokeOdbc() override;
+		Local<Value> CreateCompletionArg() override;
+
+	private:
+		static Local<Value> cell_value(const vector<shared_ptr<Column>> & pieces);
+		size_t _maxRows;
+		size_t _maxBytes;
+	};
+}
@@ -1,5 +1,8 @@
 #include "stdafx.h"
+#include <OdbcConnection.h>
 #include <OdbcStatement.h>
+#include <OdbcStatementCache.h>
+#include <OperationManager.h>
 #include <ReadNextResultOperation.h>
 
 namespace mssql
@@ -21,7 +24,28 @@ namespace mssql
 		more_meta->Set(fact.newString("meta"), _statement->get_meta_value());
 		more_meta->Set(fact.newString("preRowCount"), fact.newInt32(static_cast<int32_t>(preRowCount)));
 		more_meta->Set(fact.newString("rowCount"), fact.newInt32(static_cast<int32_t>(postRowCount)));
+		if (finished())
+		{
+			if (_unbind) {
+				more_meta->Set(fact.newString("outputParams"), _statement->unbind_params()->Clone());
+			}
+			more_meta->Set(fact.newString("freed"), fact.newBoolean(_free));
+		}
 
 		return more_meta;
 	}
+
+	bool ReadNextResultOperation::finished() const
+	{
+		return _statement != nullptr && _statement->end_of_results();
+	}
+
+	void ReadNextResultOperation::complete_foreground()
+	{
+		OdbcOperation::complete_foreground();
+		if (_free && finished()) {
+			_connection->statements->checkin(_statementId);
+			mgr->untag_statement(_statementId);
+		}
+	}
 }
@@ -28,11 +28,14 @@ namespace mssql
 
 	class OdbcConnection;
 
+	// when this read reaches the end of the results, free_statement checks the statement in and
+	// unbind returns the output parameters with the completion, saving js a call for each.
+
 	class ReadNextResultOperation : public OdbcOperation
 	{
 	public:
-		ReadNextResultOperation(shared_ptr<OdbcConnection> connection, size_t queryId, Handle<Object> callback)
-			: OdbcOperation(connection, callback), preRowCount(-1), postRowCount(-1)
+		ReadNextResultOperation(shared_ptr<OdbcConnection> connection, size_t queryId, Handle<Object> callback, bool free_statement = false, bool unbind = false)
+			: OdbcOperation(connection, callback), preRowCount(-1), postRowCount(-1), _free(free_statement), _unbind(unbind)
 		{
 			_statementId = queryId;
 		}
@@ -40,8 +43,14 @@ namespace mssql
 		bool TryInvokeOdbc() override;
 
 		Local<Value> CreateCompletionArg() override;
+		void complete_foreground() override;
 		SQLLEN preRowCount;
 		SQLLEN postRowCount;
+
+	private:
+		bool finished() const;
+		bool _free;
+		bool _unbind;
 	};
 }
 
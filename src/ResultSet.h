@@ -91,4 +91,17 @@ namespace mssql
 
 		friend class OdbcStatement;
     };
+
+	// a result set fetched to the end by OdbcStatement::try_read_all. Cells are held row by row,
+	// each as its column value or, for a lob read a packet at a time, all of its pieces.
+
+	struct DrainedResult
+	{
+		typedef vector<shared_ptr<Column>> cell_t;
+
+		DrainedResult(shared_ptr<ResultSet> r) : results(r), rows(0) {}
+		shared_ptr<ResultSet> results;
+		vector<cell_t> cells;
+		size_t rows;
+	};
 }
@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include <ResultSet.h>
+#include <RowExporter.h>
+
+namespace mssql
+{
+	const size_t export_chunk_chars = 4096;
+
+	RowExporter::RowExporter(const Format format, const char delimiter) :
+		_format(format),
+		_delimiter(delimiter)
+	{
+		_chunk.resize(export_chunk_chars);
+	}
+
+	void RowExporter::columns(ResultSet & resultset)
+	{
+		const auto count = resultset.get_column_count();
+		_kinds.resize(count);
+		_keys.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto & def = resultset.get_meta_data(static_cast<int>(i));
+			switch (def.dataType)
+			{
+			case SQL_TINYINT:
+			case SQL_SMALLINT:
+			case SQL_INTEGER:
+			case SQL_BIGINT:
+			case SQL_REAL:
+			case SQL_FLOAT:
+			case SQL_DOUBLE:
+			case SQL_DECIMAL:
+			case SQL_NUMERIC:
+				_kinds[i] = NUMBER;
+				break;
+
+			case SQL_BIT:
+				_kinds[i] = BIT;
+				break;
+
+			default:
+				_kinds[i] = TEXT;
+				break;
+			}
+
+			_out.clear();
+			if (_format == NDJSON) {
+				_out.push_back(i == 0 ? '{' : ',');
+				put_json_string(def.name.c_str(), def.name.size());
+				_out.push_back(':');
+			} else {
+				_field = def.name;
+				put_csv_field();
+			}
+			_keys[i] = _out;
+		}
+
+		_out.clear();
+		if (_format == CSV && count > 0) {
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (i > 0) _out.push_back(_delimiter);
+				_out += _keys[i];
+			}
+			_out += "\r\n";
+		}
+	}
+
+	// read a whole column value, a chunk at a time for long values.
+
+	SQLRETURN RowExporter::read_field(SQLHSTMT statement, const int column, bool & is_null)
+	{
+		_field.clear();
+		is_null = false;
+		const auto bytes = static_cast<SQLLEN>(_chunk.size() * sizeof(wchar_t));
+		for (;;)
+		{
+			SQLLEN ind = 0;
+			const auto ret = SQLGetData(statement, static_cast<SQLUSMALLINT>(column + 1), SQL_C_WCHAR, _chunk.data(), bytes, &ind);
+			if (ret == SQL_NO_DATA) return SQL_SUCCESS;
+			if (!SQL_SUCCEEDED(ret)) return ret;
+			if (ind == SQL_NULL_DATA) {
+				is_null = true;
+				return SQL_SUCCESS;
+			}
+			const auto whole = ind != SQL_NO_TOTAL && ind < bytes;
+			const auto chars = whole ? ind / sizeof(wchar_t) : _chunk.size() - 1;
+			_field.append(_chunk.data(), chars);
+			if (whole) return SQL_SUCCESS;
+		}
+	}
+
+	void RowExporter::put_utf8(const wchar_t * text, const size_t len)
+	{
+		if (len == 0) return;
+		const auto at = _out.size();
+		_out.resize(at + len * 3);
+		const auto written = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(len), &_out[at], static_cast<int>(len * 3), nullptr, nullptr);
+		_out.resize(at + written);
+	}
+
+	void RowExporter::put_csv_field()
+	{
+		const auto needs_quote = _field.find_first_of(L"\"\r\n") != wstring::npos
+			|| _field.find(static_cast<wchar_t>(_delimiter)) != wstring::npos;
+		if (!needs_quote) {
+			put_utf8(_field.c_str(), _field.size());
+			return;
+		}
+		_out.push_back('"');
+		size_t start = 0;
+		for (;;)
+		{
+			const auto q = _field.find(L'"', start);
+			const auto end = q == wstring::npos ? _field.size() : q + 1;
+			put_utf8(_field.c_str() + start, end - start);
+			if (q == wstring::npos) break;
+			_out.push_back('"');
+			start = end;
+		}
+		_out.push_back('"');
+	}
+
+	// the driver renders a decimal below one without its leading zero.
+
+	void RowExporter::put_number()
+	{
+		auto start = _field.c_str();
+		if (*start == L'-') {
+			_out.push_back('-');
+			++start;
+		}
+		if (*start == L'.') _out.push_back('0');
+		put_utf8(start, _field.size() - (start - _field.c_str()));
+	}
+
+	void RowExporter::put_json_string(const wchar_t * text, const size_t len)
+	{
+		static const char hex[] = "0123456789abcdef";
+		_out.push_back('"');
+		size_t start = 0;
+		for (size_t i = 0; i < len; ++i)
+		{
+			const auto c = text[i];
+			if (c >= 0x20 && c != L'"' && c != L'\\') continue;
+			put_utf8(text + start, i - start);
+			start = i + 1;
+			_out.push_back('\\');
+			switch (c)
+			{
+			case L'"': _out.push_back('"'); break;
+			case L'\\': _out.push_back('\\'); break;
+			case L'\n': _out.push_back('n'); break;
+			case L'\r': _out.push_back('r'); break;
+			case L'\t': _out.push_back('t'); break;
+			default:
+				_out += "u00";
+				_out.push_back(hex[(c >> 4) & 0xf]);
+				_out.push_back(hex[c & 0xf]);
+				break;
+			}
+		}
+		put_utf8(text + start, len - start);
+		_out.push_back('"');
+	}
+
+	SQLRETURN RowExporter::append_row(SQLHSTMT statement)
+	{
+		const auto count = _kinds.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			bool is_null;
+			const auto ret = read_field(statement, static_cast<int>(i), is_null);
+			if (!SQL_SUCCEEDED(ret)) return ret;
+			if (_format == CSV) {
+				if (i > 0) _out.push_back(_delimiter);
+				if (is_null) continue;
+				if (_kinds[i] == NUMBER) put_number();
+				else put_csv_field();
+				continue;
+			}
+			_out += _keys[i];
+			if (is_null) {
+				_out += "null";
+			} else if (_kinds[i] == BIT) {
+				_out += _field == L"1" ? "true" : "false";
+			} else if (_kinds[i] == NUMBER) {
+				put_number();
+			} else {
+				put_json_string(_field.c_str(), _field.size());
+			}
+		}
+		if (_format == NDJSON) _out += count > 0 ? "}\n" : "{}\n";
+		else _out += "\r\n";
+		return SQL_SUCCESS;
+	}
+}
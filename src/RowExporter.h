@@ -0,0 +1,76 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: RowExporter.h
+// Contents: serialise fetched rows to csv or ndjson text on the background thread
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+
+#pragma once
+
+namespace mssql
+{
+	using namespace std;
+
+	class ResultSet;
+
+	struct ExportOptions
+	{
+		int format;
+		char delimiter;
+		size_t chunk_bytes;	// rows are fetched until at least this much text is held
+	};
+
+	// each column is read as utf16 with SQLGetData and written as utf8. in csv a null is
+	// an empty field, in ndjson numbers and bits are written bare and null as null. numbers
+	// are written with a leading zero in both.
+
+	class RowExporter
+	{
+	public:
+		enum Format
+		{
+			CSV,
+			NDJSON
+		};
+
+		RowExporter(Format format, char delimiter);
+		void columns(ResultSet & resultset);
+		SQLRETURN append_row(SQLHSTMT statement);
+		string & data() { return _out; }
+
+	private:
+		enum Kind
+		{
+			TEXT,
+			NUMBER,
+			BIT
+		};
+
+		SQLRETURN read_field(SQLHSTMT statement, int column, bool & is_null);
+		void put_utf8(const wchar_t * text, size_t len);
+		void put_csv_field();
+		void put_number();
+		void put_json_string(const wchar_t * text, size_t len);
+
+		Format _format;
+		char _delimiter;
+		vector<Kind> _kinds;
+		vector<string> _keys;
+		vector<wchar_t> _chunk;
+		wstring _field;
+		string _out;
+	};
+}
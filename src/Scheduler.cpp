@@ -0,0 +1,149 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Scheduler.cpp
+// Contents: order in which the driver workers take queued operations
+//
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include <Scheduler.h>
+#include <Operation.h>
+
+namespace mssql
+{
+	Scheduler::Scheduler(const vector<ClassOptions> & classes, const size_t queues) :
+		_queues(queues)
+	{
+		for (const auto & c : classes)
+		{
+			_classes.push_back(make_unique<Class>());
+			_classes.back()->options = c;
+		}
+		for (auto & q : _queues)
+		{
+			q.lanes.resize(_classes.size());
+		}
+	}
+
+	void Scheduler::push(const size_t queue, const shared_ptr<Operation> & op)
+	{
+		if (op->schedule.klass >= _classes.size()) op->schedule.klass = 0;
+		op->queued_at = chrono::steady_clock::now();
+		auto & lane = _queues[queue].lanes[op->schedule.klass];
+		auto & flow = lane.flows[op->schedule.flow];
+		if (flow.empty()) lane.turns.push_back(op->schedule.flow);
+		flow.push_back(op);
+		++_classes[op->schedule.klass]->queued;
+	}
+
+	// the class whose turn would start earliest in virtual time goes next, skipping any at
+	// their cap; its clock then moves on by the inverse of its weight, so a class idle for a
+	// while gets no credit for the time it was idle. null when nothing can run.
+
+	shared_ptr<Operation> Scheduler::pick(const size_t queue)
+	{
+		auto & q = _queues[queue];
+		vector<bool> capped(_classes.size(), false);
+		size_t best;
+		auto best_start = 0.0;
+		while (true)
+		{
+			best = _classes.size();
+			for (size_t c = 0; c < _classes.size(); ++c)
+			{
+				const auto & lane = q.lanes[c];
+				if (lane.turns.empty() || capped[c]) continue;
+				const auto start = max(q.clock, lane.finish);
+				if (best == _classes.size() || start < best_start)
+				{
+					best = c;
+					best_start = start;
+				}
+			}
+			if (best == _classes.size()) return nullptr;
+			if (admit_or_wait(*_classes[best], queue)) break;
+			capped[best] = true;
+		}
+
+		auto & k = *_classes[best];
+		auto & lane = q.lanes[best];
+		q.clock = best_start;
+		lane.finish = best_start + 1.0 / k.options.weight;
+		const auto tenant = lane.turns.front();
+		lane.turns.pop_front();
+		auto & flow = lane.flows[tenant];
+		auto op = flow.front();
+		flow.pop_front();
+		if (flow.empty()) lane.flows.erase(tenant);
+		else lane.turns.push_back(tenant);
+
+		const auto waited = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - op->queued_at).count();
+		--k.queued;
+		++k.dispatched;
+		k.wait_micros_total += waited;
+		auto longest = k.wait_micros_max.load();
+		while (waited > longest && !k.wait_micros_max.compare_exchange_weak(longest, waited)) {}
+		return op;
+	}
+
+	// take a running place in the class, if it has one free.
+
+	bool Scheduler::admit(Class & k) const
+	{
+		const auto cap = static_cast<int64_t>(k.options.max_running);
+		auto running = k.running.load();
+		do {
+			if (cap > 0 && running >= cap) return false;
+		} while (!k.running.compare_exchange_weak(running, running + 1));
+		return true;
+	}
+
+	// a queue turned away by the cap is noted before trying once more, so a place freed in
+	// between is either taken here or reported to the queue by release.
+
+	bool Scheduler::admit_or_wait(Class & k, const size_t queue) const
+	{
+		if (admit(k)) return true;
+		lock_guard<mutex> lock(k.capped_lock);
+		if (admit(k)) return true;
+		k.capped.insert(queue);
+		return false;
+	}
+
+	// the running place is given up. for a capped class, the queues its cap held back are
+	// returned for the caller to wake; they are no longer noted.
+
+	vector<size_t> Scheduler::release(const size_t klass)
+	{
+		auto & k = *_classes[klass];
+		--k.running;
+		vector<size_t> waiting;
+		if (k.options.max_running == 0) return waiting;
+		lock_guard<mutex> lock(k.capped_lock);
+		waiting.assign(k.capped.begin(), k.capped.end());
+		k.capped.clear();
+		return waiting;
+	}
+
+	vector<Scheduler::ClassStats> Scheduler::stats() const
+	{
+		vector<ClassStats> stats;
+		for (const auto & c : _classes)
+		{
+			const auto & k = *c;
+			stats.push_back({ k.options, k.queued.load(), k.running.load(), k.dispatched.load(), k.wait_micros_total.load(), k.wait_micros_max.load() });
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,105 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Scheduler.h
+// Contents: order in which the driver workers take queued operations
+//
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdafx.h>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <set>
+#include <atomic>
+
+namespace mssql
+{
+	using namespace std;
+
+	class Operation;
+
+	// one queue per worker, split by priority class, the classes taking turns in proportion to
+	// their weight (start time fair queueing, each operation one unit of service), and within
+	// a class by tenant, served round robin. a class may also be capped in how many of its
+	// operations run at once across all queues.
+	//
+	// the caller holds a queue's lock around push and pick on it; the class counters are
+	// shared between queues. no threads are involved, so a scheduler can be driven directly.
+
+	class Scheduler
+	{
+	public:
+		struct ClassOptions
+		{
+			wstring name;
+			double weight;
+			size_t max_running;		// 0 for no cap
+		};
+
+		struct ClassStats
+		{
+			ClassOptions options;
+			int64_t queued;
+			int64_t running;
+			int64_t dispatched;
+			int64_t wait_micros_total;
+			int64_t wait_micros_max;
+		};
+
+		Scheduler(const vector<ClassOptions> & classes, size_t queues);
+		size_t class_count() const { return _classes.size(); }
+		void push(size_t queue, const shared_ptr<Operation> & op);
+		shared_ptr<Operation> pick(size_t queue);
+		vector<size_t> release(size_t klass);
+		vector<ClassStats> stats() const;
+
+	private:
+		struct Lane
+		{
+			Lane() : finish(0) {}
+			double finish;		// virtual time at which the class's last turn ended
+			map<size_t, deque<shared_ptr<Operation>>> flows;
+			deque<size_t> turns;	// tenants with work queued, in the order they are served
+		};
+
+		struct Queue
+		{
+			Queue() : clock(0) {}
+			vector<Lane> lanes;		// one per class
+			double clock;		// start time of the turn last taken
+		};
+
+		struct Class
+		{
+			Class() : queued(0), running(0), dispatched(0), wait_micros_total(0), wait_micros_max(0) {}
+			ClassOptions options;
+			atomic<int64_t> queued;
+			atomic<int64_t> running;
+			atomic<int64_t> dispatched;
+			atomic<int64_t> wait_micros_total;
+			atomic<int64_t> wait_micros_max;
+			mutex capped_lock;
+			set<size_t> capped;		// queues holding work this class's cap kept back
+		};
+
+		bool admit(Class & k) const;
+		bool admit_or_wait(Class & k, size_t queue) const;
+
+		vector<unique_ptr<Class>> _classes;
+		vector<Queue> _queues;
+	};
+}
@@ -45,6 +45,11 @@ namespace mssql
 		  return more;
 	   }
 
+	   size_t Bytes() const override
+	   {
+		  return size * sizeof(uint16_t);
+	   }
+
     private:
 
 	   shared_ptr<DatumStorage> storage;
@@ -56,32 +56,6 @@ namespace mssql
 		return string(message_buffer.data());
 	}
 
-	int char2_int(const char input)
-	{
-		if (input >= '0' && input <= '9')
-			return input - '0';
-		if (input >= 'A' && input <= 'F')
-			return input - 'A' + 10;
-		if (input >= 'a' && input <= 'f')
-			return input - 'a' + 10;
-		throw invalid_argument("Invalid input string");
-	}
-
-	// This function assumes src to be a zero terminated sanitized string with
-	// an even number of [0-9a-f] characters, and target to be sufficiently large
-
-	int hex2_bin(const char* src, char* target)
-	{
-		auto len = 0;
-		while (*src && src[1])
-		{
-			*(target++) = char2_int(*src) * 16 + char2_int(src[1]);
-			src += 2;
-			++len;
-		}
-		return len;
-	}
-
 	double round(const double val, const int dp)
 	{
 		const auto raised = pow(10, dp);
@@ -95,50 +69,156 @@ namespace mssql
 		return rounded / raised;
 	}
 
-	string hexify(unsigned long long n)
-	{
-		string res;
+	const int max_numeric_digits = 38;
+
+	// mantissa = mantissa * m + carry over four 32 bit limbs, false on overflow of 128 bits
 
-		do
+	static bool mul_add(uint32_t *mantissa, const uint32_t m, uint32_t carry)
+	{
+		for (auto i = 0; i < 4; ++i)
 		{
-			res += "0123456789ABCDEF"[n % 16];
-			n >>= 4;
-		} while (n);
+			const auto t = static_cast<uint64_t>(mantissa[i]) * m + carry;
+			mantissa[i] = static_cast<uint32_t>(t);
+			carry = static_cast<uint32_t>(t >> 32);
+		}
+		return carry == 0;
+	}
 
-		return string(res.rbegin(), res.rend());
+	static int count_digits(const uint32_t *mantissa)
+	{
+		uint32_t v[4] = { mantissa[0], mantissa[1], mantissa[2], mantissa[3] };
+		auto digits = 0;
+		while (v[0] || v[1] || v[2] || v[3])
+		{
+			uint64_t rem = 0;
+			for (auto i = 3; i >= 0; --i)
+			{
+				const auto cur = (rem << 32) | v[i];
+				v[i] = static_cast<uint32_t>(cur / 10);
+				rem = cur % 10;
+			}
+			++digits;
+		}
+		return digits;
 	}
 
-	void encode_numeric_struct(const double v, const int precision, int upscale_limit, SQL_NUMERIC_STRUCT & numeric) {
-		auto encode = fabs(v);
-		double intpart;
-		auto scale = 0;
-		char hex[SQL_MAX_NUMERIC_LEN];
+	// parse [-]digits[.digits][e[-]digits] exactly, rounding half away from zero to max_scale
+	// (or 38 when max_scale < 0).  Returns false for malformed input or more than 38 digits.
+
+	bool parse_numeric(const char *s, const int max_scale, numeric_value & n)
+	{
+		memset(&n, 0, sizeof(n));
+		while (*s == ' ') ++s;
+		if (*s == '-' || *s == '+')
+		{
+			n.negative = *s == '-';
+			++s;
+		}
+
+		const auto mantissa_start = s;
+		auto total = 0;
+		auto frac = 0;
+		auto point = false;
+		for (; *s; ++s)
+		{
+			if (*s >= '0' && *s <= '9')
+			{
+				++total;
+				if (point) ++frac;
+			}
+			else if (*s == '.' && !point) point = true;
+			else break;
+		}
+		if (total == 0) return false;
+		const auto mantissa_end = s;
+
+		auto exponent = 0;
+		if (*s == 'e' || *s == 'E')
+		{
+			++s;
+			auto negative_exponent = false;
+			if (*s == '-' || *s == '+')
+			{
+				negative_exponent = *s == '-';
+				++s;
+			}
+			if (*s < '0' || *s > '9') return false;
+			while (*s >= '0' && *s <= '9')
+			{
+				exponent = exponent * 10 + (*s - '0');
+				if (exponent > 1000) return false;
+				++s;
+			}
+			if (negative_exponent) exponent = -exponent;
+		}
+		while (*s == ' ') ++s;
+		if (*s) return false;
 
-		if (upscale_limit <= 0) upscale_limit = SQL_MAX_NUMERIC_LEN;
+		const auto limit = max_scale >= 0 ? min(max_scale, max_numeric_digits) : max_numeric_digits;
+		auto scale = frac - exponent;
+		auto keep = total;
+		if (scale > limit)
+		{
+			keep = total - (scale - limit);
+			scale = limit;
+		}
+
+		auto round_up = false;
+		auto seen = 0;
+		for (auto p = mantissa_start; keep >= 0 && p != mantissa_end; ++p)
+		{
+			if (*p == '.') continue;
+			if (seen++ == keep)
+			{
+				round_up = *p >= '5';
+				break;
+			}
+			const uint32_t d = *p - '0';
+			if (n.digits == 0 && d == 0) continue;
+			if (++n.digits > max_numeric_digits || !mul_add(n.mantissa, 10, d)) return false;
+		}
 
-		auto dmod = modf(encode, &intpart);
-		while (scale < upscale_limit && dmod != 0.0)
+		if (round_up)
 		{
-			++scale;
-			encode = encode * 10;
-			dmod = modf(encode, &intpart);
+			mul_add(n.mantissa, 1, 1);
+			n.digits = count_digits(n.mantissa);
+			if (n.digits > max_numeric_digits) return false;
 		}
 
-		const auto ull = static_cast<unsigned long long>(encode);
-		memset(numeric.val, 0, SQL_MAX_NUMERIC_LEN);
-		memset(hex, 0, SQL_MAX_NUMERIC_LEN);
-		auto ss = hexify(ull);
-		if (ss.size() % 2 == 1) ss = "0" + ss;
-		const auto len = hex2_bin(ss.c_str(), hex);
-		auto j = 0;
-		for (auto i = len - 1; i >= 0; --i)
+		n.scale = scale;
+		if (scale < 0 && !rescale_numeric(n, 0)) return false;
+
+		if (n.digits == 0) n.negative = false;
+		return true;
+	}
+
+	// move to a larger scale i.e. append zeros to the mantissa, scale may be negative to start.
+
+	bool rescale_numeric(numeric_value & n, const int scale)
+	{
+		for (auto s = n.scale; s < scale; ++s)
+		{
+			if (n.digits == 0) continue;
+			if (++n.digits > max_numeric_digits || !mul_add(n.mantissa, 10, 0)) return false;
+		}
+		n.scale = max(n.scale, scale);
+		return true;
+	}
+
+	void encode_numeric_struct(const numeric_value & n, const int precision, SQL_NUMERIC_STRUCT & numeric)
+	{
+		for (auto i = 0; i < 4; ++i)
 		{
-			numeric.val[j++] = hex[i];
+			const auto limb = n.mantissa[i];
+			numeric.val[i * 4] = static_cast<SQLCHAR>(limb);
+			numeric.val[i * 4 + 1] = static_cast<SQLCHAR>(limb >> 8);
+			numeric.val[i * 4 + 2] = static_cast<SQLCHAR>(limb >> 16);
+			numeric.val[i * 4 + 3] = static_cast<SQLCHAR>(limb >> 24);
 		}
 
-		numeric.sign = v >= 0.0 ? 1 : 0;
-		numeric.precision = precision > 0 ? precision : static_cast<SQLCHAR>(log10(encode) + 1);
-		numeric.scale = min(upscale_limit, scale);
+		numeric.sign = n.negative ? 0 : 1;
+		numeric.scale = static_cast<SQLSCHAR>(n.scale);
+		numeric.precision = static_cast<SQLCHAR>(precision > 0 ? precision : max(max(n.digits, n.scale), 1));
 	}
 
 
@@ -34,7 +34,20 @@ namespace mssql
     }
 
     wstring FromV8String(Handle<String> input);
-	void encode_numeric_struct(double v, int precision, int upscaleLimit, SQL_NUMERIC_STRUCT & numeric);
+
+	// a decimal held exactly as an unscaled integer of up to 38 digits, value = mantissa / 10^scale
+
+	struct numeric_value
+	{
+		uint32_t mantissa[4];
+		int scale;
+		int digits;
+		bool negative;
+	};
+
+	bool parse_numeric(const char *s, int max_scale, numeric_value & n);
+	bool rescale_numeric(numeric_value & n, int scale);
+	void encode_numeric_struct(const numeric_value & n, int precision, SQL_NUMERIC_STRUCT & numeric);
 
     string w2a(const wchar_t* input);
 
@@ -0,0 +1,288 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: WorkerPool.cpp
+// Contents: threads owned by the driver on which odbc calls are made
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include <WorkerPool.h>
+#include <Operation.h>
+#include <OperationManager.h>
+
+namespace mssql
+{
+	size_t WorkerPool::_size = 0;
+	bool WorkerPool::_classesFixed = false;
+
+	WorkerPool & WorkerPool::instance()
+	{
+		// never destroyed, the workers are detached and run until the process exits
+		static auto pool = new WorkerPool();
+		return *pool;
+	}
+
+	// only effective before the first operation starts the workers. 
+
+	bool WorkerPool::set_size(const size_t size)
+	{
+		if (size == 0 || !instance()._workers.empty()) return false;
+		_size = size;
+		return true;
+	}
+
+	vector<WorkerPool::ClassOptions> & WorkerPool::class_options()
+	{
+		static vector<ClassOptions> options{ { L"default", 1.0, 0 } };
+		return options;
+	}
+
+	// like the size, fixed once the first class is named or the workers start. The first class
+	// is where operations with no class, or one not configured, are queued.
+
+	bool WorkerPool::set_classes(const vector<ClassOptions> & classes)
+	{
+		if (classes.empty() || _classesFixed) return false;
+		for (const auto & c : classes)
+		{
+			if (!(c.weight > 0)) return false;
+		}
+		class_options() = classes;
+		return true;
+	}
+
+	size_t WorkerPool::class_index(const wstring & name)
+	{
+		_classesFixed = true;
+		const auto & options = class_options();
+		for (size_t i = 0; i < options.size(); ++i)
+		{
+			if (options[i].name == name) return i;
+		}
+		return 0;
+	}
+
+	// the number of workers, or that they will start with.
+
+	size_t WorkerPool::size()
+	{
+		auto & pool = instance();
+		if (!pool._workers.empty()) return pool._workers.size();
+		return _size > 0 ? _size : max<size_t>(4, thread::hardware_concurrency());
+	}
+
+	WorkerPool::WorkerPool() : 
+		_next(0),
+		_pending(0)
+	{
+		uv_async_init(uv_default_loop(), &_async, on_async);
+		_async.data = this;
+		uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+	}
+
+	void WorkerPool::start()
+	{
+		const auto size = WorkerPool::size();
+		_classesFixed = true;
+		_scheduler = make_unique<Scheduler>(class_options(), size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			_workers.push_back(make_unique<Worker>());
+		}
+		for (size_t i = 0; i < size; ++i)
+		{
+			thread(&WorkerPool::run, this, i).detach();
+		}
+	}
+
+	// connections are spread over the workers in turn as they are created.
+
+	size_t WorkerPool::assign()
+	{
+		return _next++;
+	}
+
+	void WorkerPool::track()
+	{
+		if (_pending++ == 0)
+		{
+			uv_ref(reinterpret_cast<uv_handle_t*>(&_async));
+		}
+	}
+
+	void WorkerPool::dispatch(const shared_ptr<Operation> & op, const size_t affinity)
+	{
+		if (_workers.empty()) start();
+		track();
+		const auto index = affinity % _workers.size();
+		{
+			lock_guard<mutex> lock(_workers[index]->lock);
+			_scheduler->push(index, op);
+		}
+		wake(index);
+	}
+
+	// the worker a queue belongs to is woken, and while it is busy an idle one as well, to
+	// take the work from it. with none idle the first to finish looks for it.
+
+	void WorkerPool::wake(const size_t index)
+	{
+		signal(*_workers[index]);
+		if (!_workers[index]->busy) return;
+		for (auto & w : _workers)
+		{
+			if (w->busy) continue;
+			signal(*w);
+			return;
+		}
+	}
+
+	void WorkerPool::signal(Worker & worker)
+	{
+		{
+			lock_guard<mutex> lock(worker.lock);
+			++worker.signals;
+		}
+		worker.ready.notify_one();
+	}
+
+	// for operations that must not wait behind the connection's queue, such as a cancel
+	// of the statement the worker is executing. they are short and run on the loop thread.
+
+	void WorkerPool::run_inline(const shared_ptr<Operation> & op)
+	{
+		track();
+		op->invoke_background();
+		completed(op);
+	}
+
+	// an operation that could not be queued completes on the next turn of the loop, so its
+	// callback is never called before the call that sent it returns.
+
+	void WorkerPool::reject(const shared_ptr<Operation> & op)
+	{
+		track();
+		completed(op);
+	}
+
+	void WorkerPool::run(const size_t index)
+	{
+		auto & worker = *_workers[index];
+		while (true)
+		{
+			size_t signals;
+			auto op = take(index, signals);
+			if (op == nullptr)
+			{
+				unique_lock<mutex> lock(worker.lock);
+				worker.ready.wait(lock, [&worker, signals] { return worker.signals != signals; });
+				continue;
+			}
+			const auto klass = op->schedule.klass;
+			op->invoke_background();
+			worker.busy = false;
+			release(klass);
+			// hand over the only reference held here, so the operation and its v8
+			// handles are always released on the loop thread.
+			completed(move(op));
+		}
+	}
+
+	// the worker's own queue first, then those of the others. the wakes counted before
+	// looking tell the caller whether any came in while it looked.
+
+	shared_ptr<Operation> WorkerPool::take(const size_t index, size_t & signals)
+	{
+		auto & worker = *_workers[index];
+		shared_ptr<Operation> op;
+		{
+			lock_guard<mutex> lock(worker.lock);
+			signals = worker.signals;
+			op = _scheduler->pick(index);
+		}
+		if (op == nullptr) op = steal(index);
+		if (op != nullptr) worker.busy = true;
+		return op;
+	}
+
+	// one queue's lock is held at a time, so workers stealing from each other cannot deadlock.
+
+	shared_ptr<Operation> WorkerPool::steal(const size_t index)
+	{
+		for (size_t i = 1; i < _workers.size(); ++i)
+		{
+			const auto other = (index + i) % _workers.size();
+			lock_guard<mutex> lock(_workers[other]->lock);
+			auto op = _scheduler->pick(other);
+			if (op != nullptr) return op;
+		}
+		return nullptr;
+	}
+
+	// a place freed in a capped class wakes only the workers its cap turned away.
+
+	void WorkerPool::release(const size_t klass)
+	{
+		for (const auto w : _scheduler->release(klass))
+		{
+			wake(w);
+		}
+	}
+
+	vector<WorkerPool::ClassStats> WorkerPool::class_stats() const
+	{
+		if (_scheduler) return _scheduler->stats();
+		vector<ClassStats> stats;
+		for (const auto & o : class_options())
+		{
+			stats.push_back({ o, 0, 0, 0, 0, 0 });
+		}
+		return stats;
+	}
+
+	void WorkerPool::completed(shared_ptr<Operation> op)
+	{
+		{
+			lock_guard<mutex> lock(_completedLock);
+			_completed.push_back(move(op));
+		}
+		uv_async_send(&_async);
+	}
+
+	void WorkerPool::on_async(uv_async_t * handle)
+	{
+		static_cast<WorkerPool*>(handle->data)->drain();
+	}
+
+	// uv_async_send may coalesce, so every completion queued so far is delivered.
+
+	void WorkerPool::drain()
+	{
+		deque<shared_ptr<Operation>> done;
+		{
+			lock_guard<mutex> lock(_completedLock);
+			done.swap(_completed);
+		}
+		for (auto & op : done)
+		{
+			op->complete_foreground();
+			op->mgr->check_in_operation(op->OperationID);
+		}
+		_pending -= done.size();
+		if (_pending == 0)
+		{
+			uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+		}
+	}
+}
@@ -0,0 +1,100 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: WorkerPool.h
+// Contents: threads owned by the driver on which odbc calls are made
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdafx.h>
+#include <Scheduler.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+namespace mssql
+{
+	using namespace std;
+
+	class Operation;
+
+	// blocking odbc calls run here rather than on the libuv threadpool, so a slow database
+	// does not starve fs, dns or crypto work. each connection is queued to one worker, and
+	// completions return to the loop through a uv_async_t.
+	//
+	// each worker takes its operations in the order its queue in the Scheduler gives. a
+	// connection has only one operation queued at a time, as its JS queue sends them in turn,
+	// so the reordering by class and tenant never crosses one. for the same reason a worker
+	// with nothing of its own to do may take work queued to one that is busy, so a slow
+	// statement never holds back the other connections sharing its worker.
+
+	class WorkerPool
+	{
+	public:
+		typedef Scheduler::ClassOptions ClassOptions;
+		typedef Scheduler::ClassStats ClassStats;
+
+		static WorkerPool & instance();
+		static bool set_size(size_t size);
+		static bool set_classes(const vector<ClassOptions> & classes);
+		static size_t class_index(const wstring & name);
+		static size_t size();
+		size_t assign();
+		void dispatch(const shared_ptr<Operation> & op, size_t affinity);
+		void run_inline(const shared_ptr<Operation> & op);
+		void reject(const shared_ptr<Operation> & op);
+		vector<ClassStats> class_stats() const;
+
+	private:
+		struct Worker
+		{
+			Worker() : signals(0), busy(false) {}
+			mutex lock;
+			condition_variable ready;
+			size_t signals;		// wakes sent, under the lock, so none is lost while looking for work
+			atomic<bool> busy;		// running an operation
+		};
+
+		WorkerPool();
+		void start();
+		void run(size_t index);
+		shared_ptr<Operation> take(size_t index, size_t & signals);
+		shared_ptr<Operation> steal(size_t index);
+		void wake(size_t index);
+		void signal(Worker & worker);
+		void release(size_t klass);
+		void completed(shared_ptr<Operation> op);
+		void drain();
+		void track();
+		static void on_async(uv_async_t * handle);
+		static vector<ClassOptions> & class_options();
+
+		static size_t _size;
+		static bool _classesFixed;
+		vector<unique_ptr<Worker>> _workers;
+		unique_ptr<Scheduler> _scheduler;
+		size_t _next;
+		uv_async_t _async;
+		mutex _completedLock;
+		deque<shared_ptr<Operation>> _completed;
+
+		// operations dispatched and not yet completed, only touched on the loop thread.
+		// the async handle holds the loop open while any are outstanding.
+		size_t _pending;
+	};
+}
@@ -3,6 +3,9 @@
 
 var supp = require('../samples/typescript/demo-support')
 var assert = require('assert')
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
 
 suite('bulk', function () {
   var theConnection
@@ -174,6 +177,74 @@ suite('bulk', function () {
     })
   })
 
+  test('bulk insert/select mixed column types with string date and all null column', function (testDone) {
+    var tableName = 'BulkMixed'
+    var bulkMgr
+    var rows = []
+    for (var i = 0; i < 5; ++i) {
+      rows.push({
+        id: i,
+        flag: i % 2 === 0,
+        amount: i * 1.5,
+        created: i === 3 ? '2018-01-02 03:04:05' : new Date(Date.UTC(2018, 0, i + 1)),
+        label: 'row ' + i,
+        note: null,
+        blob: Buffer.from([i, i + 1])
+      })
+    }
+
+    var fns = [
+      function (asyncDone) {
+        theConnection.query('if object_id(\'dbo.' + tableName + '\', \'U\') is not null drop table dbo.' + tableName, function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('create table ' + tableName + ' (id int, flag bit, amount float, created datetime2, label nvarchar(50), note nvarchar(max) null, blob varbinary(10))', function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.tableMgr().bind(tableName, function (bm) {
+          bulkMgr = bm
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        bulkMgr.insertRows(rows, function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select id, flag, amount, label, note, blob, convert(varchar(19), created, 120) as created from ' + tableName + ' order by id', function (err, res) {
+          assert.ifError(err)
+          assert.strictEqual(res.length, rows.length)
+          res.forEach(function (r, j) {
+            assert.strictEqual(r.id, rows[j].id)
+            assert.strictEqual(r.flag, rows[j].flag)
+            assert.strictEqual(r.amount, rows[j].amount)
+            assert.strictEqual(r.label, rows[j].label)
+            assert.strictEqual(r.note, null)
+            assert.deepStrictEqual(r.blob, rows[j].blob)
+          })
+          assert.strictEqual(res[3].created, '2018-01-02 03:04:05')
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
   function bindInsert (tableName, done) {
     var bulkMgr
     var parsedJSON = helper.getJSON()
@@ -587,6 +658,21 @@ suite('bulk', function () {
     varcharTest(test2BatchSize, true, true, true, testDone)
   })
 
+  test('bulk insert/select varchar column with non ascii text batchSize ' + test2BatchSize, function (testDone) {
+    var params = {
+      columnType: 'varchar(100)',
+      buildFunction: function (i) {
+        return i % 2 === 0 ? 'ascii ' + i : 'caf\u00e9 ' + i
+      },
+      updateFunction: null,
+      check: true,
+      deleteAfterTest: false,
+      batchSize: test2BatchSize
+    }
+
+    simpleColumnBulkTest(params, testDone)
+  })
+
   test('bulk insert simple multi-column object in batches ' + test2BatchSize, function (testDone) {
     function buildTest (count) {
       var arr = []
@@ -638,6 +724,766 @@ suite('bulk', function () {
     }
   })
 
+  test('bulk copy simple multi-column object with bcp in batches ' + test2BatchSize, function (testDone) {
+    function buildTest (count) {
+      var arr = []
+      for (var i = 0; i < count; ++i) {
+        arr.push({
+          pkid: i,
+          num1: i * 3,
+          num2: i * 4,
+          num3: i % 2 === 0 ? null : i * 32,
+          st: 'bcp ' + i
+        })
+      }
+      return arr
+    }
+
+    var tableName = 'BulkTest'
+    var count = test2BatchSize * 3 + 1
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var vec = buildTest(count)
+      theConnection.bulkCopy(tableName, vec, {
+        batchSize: test2BatchSize,
+        tableLock: true
+      }, function (err, copied) {
+        assert.ifError(err)
+        assert.strictEqual(copied, count)
+        theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+          assert.ifError(err)
+          assert.deepEqual(results, vec, 'results didn\'t match')
+          testDone()
+        })
+      })
+    }
+  })
+
+  test('bulk insert multi-column objects from a writable stream in batches ' + test2BatchSize, function (testDone) {
+    var tableName = 'BulkTest'
+    var count = test2BatchSize * 2 + 5
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      var insertStream = tm.createInsertStream(tableName, {
+        batchSize: test2BatchSize
+      })
+      var batches = []
+      insertStream.on('batch', function (rows) {
+        batches.push(rows)
+      })
+      insertStream.on('error', function (err) {
+        assert.ifError(err)
+      })
+      insertStream.on('finish', function () {
+        assert.deepEqual(batches, [test2BatchSize, test2BatchSize, 5])
+        theConnection.query('select count(*) as count from ' + tableName, function (err, results) {
+          assert.ifError(err)
+          assert.deepEqual(results, [{
+            count: count
+          }])
+          testDone()
+        })
+      })
+      for (var i = 0; i < count; ++i) {
+        insertStream.write({
+          pkid: i,
+          num1: i * 3,
+          num2: i * 4,
+          num3: null,
+          st: 'stream ' + i
+        })
+      }
+      insertStream.end()
+    }
+  })
+
+  test('bulk insert stream reports a failed batch once', function (testDone) {
+    var tableName = 'BulkTest'
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      var insertStream = tm.createInsertStream(tableName, {
+        batchSize: 2
+      })
+      var errors = []
+      insertStream.on('error', function (err) {
+        errors.push(err)
+        // a second call of the write callback would raise its own error shortly after
+        setTimeout(function () {
+          assert.strictEqual(errors.length, 1)
+          testDone()
+        }, 200)
+      })
+      insertStream.write({
+        pkid: 1,
+        num1: 1,
+        num2: 1,
+        num3: null,
+        st: 'first'
+      })
+      insertStream.write({
+        pkid: 1,
+        num1: 2,
+        num2: 2,
+        num3: null,
+        st: 'duplicate key'
+      })
+      insertStream.end()
+    }
+  })
+
+  test('bulk select many keys in reverse order through a single join', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 50
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: i % 2 === 0 ? null : i * 32,
+        st: 'key ' + i
+      })
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        bulkMgr.setSelectJoinThreshold(10)
+        bulkMgr.insertRows(vec, function (err) {
+          assert.ifError(err)
+          var keys = vec.map(function (row) {
+            return {
+              pkid: row.pkid
+            }
+          }).reverse()
+          bulkMgr.selectRows(keys, function (err, results) {
+            assert.ifError(err)
+            assert.deepEqual(results, vec.slice().reverse(), 'results didn\'t match')
+            testDone()
+          })
+        })
+      })
+    }
+  })
+
+  test('bulk select a few keys below the join threshold with the parameterised select', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 5
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'key ' + i
+      })
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        bulkMgr.setSelectJoinThreshold(count + 1)
+        bulkMgr.insertRows(vec, function (err) {
+          assert.ifError(err)
+          var keys = vec.map(function (row) {
+            return {
+              pkid: row.pkid
+            }
+          }).reverse()
+          bulkMgr.selectRows(keys, function (err, results) {
+            assert.ifError(err)
+            assert.deepEqual(results, vec.slice().reverse(), 'results didn\'t match')
+            testDone()
+          })
+        })
+      })
+    }
+  })
+
+  test('bulk upsert multi-column objects updates existing and inserts new rows', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 20
+
+    function buildRows (from, to, tag) {
+      var arr = []
+      for (var i = from; i < to; ++i) {
+        arr.push({
+          pkid: i,
+          num1: i * 3,
+          num2: i * 4,
+          num3: null,
+          st: tag + i
+        })
+      }
+      return arr
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        bulkMgr.insertRows(buildRows(0, count / 2, 'old '), function (err) {
+          assert.ifError(err)
+          var upsert = buildRows(0, count, 'new ')
+          bulkMgr.upsertRows(upsert, function (err, counts) {
+            assert.ifError(err)
+            assert.deepEqual(counts, {
+              inserted: count / 2,
+              updated: count / 2
+            })
+            theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+              assert.ifError(err)
+              assert.deepEqual(results, upsert, 'results didn\'t match')
+              testDone()
+            })
+          })
+        })
+      })
+    }
+  })
+
+  test('bulk update and delete above the join threshold apply rows with one join', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 50
+
+    function buildRows (tag) {
+      var arr = []
+      for (var i = 0; i < count; ++i) {
+        arr.push({
+          pkid: i,
+          num1: i * 3,
+          num2: i * 4,
+          num3: null,
+          st: tag + i
+        })
+      }
+      return arr
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        bulkMgr.setJoinThreshold(10)
+        bulkMgr.insertRows(buildRows('old '), function (err) {
+          assert.ifError(err)
+          var updated = buildRows('new ')
+          bulkMgr.updateRows(updated, function (err) {
+            assert.ifError(err)
+            var removed = updated.filter(function (row) {
+              return row.pkid % 2 === 0
+            })
+            bulkMgr.deleteRows(removed, function (err) {
+              assert.ifError(err)
+              theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+                assert.ifError(err)
+                assert.deepEqual(results, updated.filter(function (row) {
+                  return row.pkid % 2 === 1
+                }), 'results didn\'t match')
+                testDone()
+              })
+            })
+          })
+        })
+      })
+    }
+  })
+
+  test('bulk insert with adaptive batch size reports size and throughput', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 2000
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'adaptive ' + i
+      })
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        bulkMgr.setAdaptiveBatchSize({
+          min: 50,
+          max: 800
+        })
+        bulkMgr.insertRows(vec, function (err) {
+          assert.ifError(err)
+          var summary = bulkMgr.getSummary()
+          assert(summary.adaptiveBatchSize)
+          assert(summary.batchSize >= 50 && summary.batchSize <= 800)
+          assert(summary.rowsPerSecond > 0)
+          theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+            assert.ifError(err)
+            assert.deepEqual(results, vec, 'results didn\'t match')
+            testDone()
+          })
+        })
+      })
+    }
+  })
+
+  test('bulk insert emits progress per batch and a final summary', function (testDone) {
+    var tableName = 'BulkTest'
+    var count = 95
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'progress ' + i
+      })
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        var progress = []
+        var summary = null
+        bulkMgr.setBatchSize(test2BatchSize)
+        bulkMgr.on('progress', function (p) {
+          progress.push(p)
+        })
+        bulkMgr.on('summary', function (s) {
+          summary = s
+        })
+        bulkMgr.insertRows(vec, function (err) {
+          assert.ifError(err)
+          assert.strictEqual(progress.length, Math.ceil(count / test2BatchSize))
+          assert.strictEqual(progress[0].rows, test2BatchSize)
+          assert(summary !== null)
+          assert.strictEqual(summary.operation, 'insert')
+          assert.strictEqual(summary.rows, count)
+          assert.strictEqual(summary.totalRows, count)
+          assert.strictEqual(summary.batches, progress.length)
+          assert.strictEqual(summary.failedBatches, 0)
+          assert.strictEqual(summary.failedRows, 0)
+          // three int columns and the text of every row, not one row's width per column.
+          assert(summary.boundBytes >= count * (3 * 4 + 'progress '.length))
+          assert(summary.executeMs > 0)
+          assert.strictEqual(summary.error, null)
+          testDone()
+        })
+      })
+    }
+  })
+
+  test('bulk insert counts the rows of a failed batch apart', function (testDone) {
+    var tableName = 'BulkTest'
+    var vec = []
+    for (var i = 0; i < test2BatchSize; ++i) {
+      vec.push({
+        pkid: i % 2,
+        num1: i,
+        num2: i,
+        num3: null,
+        st: 'dup ' + i
+      })
+    }
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      var tm = theConnection.tableMgr()
+      tm.bind(tableName, function (bulkMgr) {
+        var summary = null
+        bulkMgr.setBatchSize(test2BatchSize)
+        bulkMgr.on('summary', function (s) {
+          summary = s
+        })
+        bulkMgr.insertRows(vec, function (err, res, more) {
+          if (more) {
+            return
+          }
+          assert(summary !== null)
+          assert(summary.error !== null || err)
+          assert.strictEqual(summary.rows, 0)
+          assert.strictEqual(summary.batches, 0)
+          assert.strictEqual(summary.failedBatches, 1)
+          assert.strictEqual(summary.failedRows, test2BatchSize)
+          testDone()
+        })
+      })
+    }
+  })
+
+  test('bulk insert batches in parallel over several connections ' + test2BatchSize, function (testDone) {
+    var tableName = 'BulkTest'
+    var count = test2BatchSize * 3 + 5
+    var connections = []
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'parallel ' + i
+      })
+    }
+
+    var fns = [
+      function (asyncDone) {
+        helper.dropCreateTable({
+          tableName: tableName
+        }, function () {
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        sql.open(connStr, function (err, conn) {
+          assert.ifError(err)
+          connections.push(conn)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        sql.open(connStr, function (err, conn) {
+          assert.ifError(err)
+          connections.push(conn)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tm = theConnection.tableMgr()
+        tm.bind(tableName, function (bulkMgr) {
+          bulkMgr.setBatchSize(test2BatchSize)
+          bulkMgr.setParallel(connections.concat([theConnection]), 2)
+          bulkMgr.insertRows(vec, function (err) {
+            assert.ifError(err)
+            asyncDone()
+          })
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+          assert.ifError(err)
+          assert.deepEqual(results, vec, 'results didn\'t match')
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        connections[0].close(function () {
+          connections[1].close(function () {
+            asyncDone()
+          })
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  test('bulk insert in parallel reports the failing batch ' + test2BatchSize, function (testDone) {
+    var tableName = 'BulkTest'
+    var count = test2BatchSize * 2
+    var connection
+    var bulkMgr
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'parallel ' + i
+      })
+    }
+    // the last batch repeats a key from the first.
+    vec[count - 1].pkid = 0
+
+    var fns = [
+      function (asyncDone) {
+        helper.dropCreateTable({
+          tableName: tableName
+        }, function () {
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        sql.open(connStr, function (err, conn) {
+          assert.ifError(err)
+          connection = conn
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tm = theConnection.tableMgr()
+        tm.bind(tableName, function (bulk) {
+          bulkMgr = bulk
+          bulkMgr.setBatchSize(test2BatchSize)
+          bulkMgr.setParallel([connection, theConnection], 2)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        bulkMgr.insertRows([], function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        bulkMgr.insertRows(vec, function (err) {
+          assert(err)
+          assert.strictEqual(err.batchErrors.length, 1)
+          assert.strictEqual(err.batchErrors[0].batch, 1)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        connection.close(function () {
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  test('staged parallel insert loads all rows or none ' + test2BatchSize, function (testDone) {
+    var tableName = 'BulkTest'
+    var count = test2BatchSize * 3 + 5
+    var connection
+    var bulkMgr
+    var summary = null
+    var vec = []
+    for (var i = 0; i < count; ++i) {
+      vec.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: null,
+        st: 'staged ' + i
+      })
+    }
+    // every batch stages; the key repeated across batches only fails the load.
+    var dup = vec.map(function (r) {
+      return {
+        pkid: r.pkid === count - 1 ? 0 : r.pkid,
+        num1: r.num1,
+        num2: r.num2,
+        num3: r.num3,
+        st: r.st
+      }
+    })
+
+    var fns = [
+      function (asyncDone) {
+        helper.dropCreateTable({
+          tableName: tableName
+        }, function () {
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        sql.open(connStr, function (err, conn) {
+          assert.ifError(err)
+          connection = conn
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tm = theConnection.tableMgr()
+        tm.bind(tableName, function (bulk) {
+          bulkMgr = bulk
+          bulkMgr.setBatchSize(test2BatchSize)
+          bulkMgr.setParallel([connection, theConnection], 2, { staged: true })
+          bulkMgr.on('summary', function (s) {
+            summary = s
+          })
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        bulkMgr.insertRows(dup, function (err) {
+          assert(err)
+          assert(summary.error)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select count(*) as n from ' + tableName, function (err, results) {
+          assert.ifError(err)
+          assert.strictEqual(results[0].n, 0)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        bulkMgr.insertRows(vec, function (err) {
+          assert.ifError(err)
+          assert.strictEqual(summary.error, null)
+          assert.strictEqual(summary.batches, 4)
+          assert.strictEqual(summary.rows, count)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+          assert.ifError(err)
+          assert.deepEqual(results, vec, 'results didn\'t match')
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        connection.close(function () {
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  test('import csv file with header and quoted fields natively', function (testDone) {
+    var tableName = 'BulkTest'
+    var file = path.join(os.tmpdir(), 'msnodesql_import_' + process.pid + '.csv')
+    var count = 25
+    var expected = []
+    var lines = ['st,num3,num2,num1,pkid']
+    for (var i = 0; i < count; ++i) {
+      var st = i % 3 === 0 ? 'quoted, "text" ' + i : 'plain ' + i
+      var num3 = i % 2 === 0 ? null : i * 32
+      expected.push({
+        pkid: i,
+        num1: i * 3,
+        num2: i * 4,
+        num3: num3,
+        st: st
+      })
+      lines.push('"' + st.replace(/"/g, '""') + '",' + (num3 === null ? '' : num3) + ',' + i * 4 + ',' + i * 3 + ',' + i)
+    }
+    fs.writeFileSync(file, lines.join('\r\n') + '\r\n')
+
+    helper.dropCreateTable({
+      tableName: tableName
+    }, go)
+
+    function go () {
+      theConnection.importFile(file, tableName, {
+        batchSize: test2BatchSize
+      }, function (err, copied) {
+        fs.unlinkSync(file)
+        assert.ifError(err)
+        assert.strictEqual(copied, count)
+        theConnection.query('select pkid, num1, num2, num3, st from ' + tableName + ' order by pkid', function (err, results) {
+          assert.ifError(err)
+          assert.deepEqual(results, expected, 'results didn\'t match')
+          testDone()
+        })
+      })
+    }
+  })
+
+  test('import a csv file whose header quotes a column name holding the delimiter', function (testDone) {
+    var tableName = 'ImportQuoted'
+    var file = path.join(os.tmpdir(), 'msnodesqlv8-import-quoted-' + process.pid + '.csv')
+    fs.writeFileSync(file, '"a,b",id\r\n"x, y",1\r\nz,2\r\n')
+
+    var fns = [
+      function (asyncDone) {
+        theConnection.query('if object_id(\'dbo.' + tableName + '\', \'U\') is not null drop table dbo.' + tableName, function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('create table ' + tableName + ' (id int, [a,b] nvarchar(20))', function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.importFile(file, tableName, {}, function (err, copied) {
+          fs.unlinkSync(file)
+          assert.ifError(err)
+          assert.strictEqual(copied, 2)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select id, [a,b] as ab from ' + tableName + ' order by id', function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(res, [{ id: 1, ab: 'x, y' }, { id: 2, ab: 'z' }])
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
   function simpleColumnBulkTest (params, completeFn) {
     var type = params.columnType
     var buildFunction = params.buildFunction
@@ -284,4 +284,383 @@ suite('concurrent', function () {
       })
     })
   })
+
+  function openMany (count, done) {
+    var connections = []
+    function next () {
+      if (connections.length === count) {
+        done(connections)
+        return
+      }
+      open(function (conn) {
+        connections.push(conn)
+        next()
+      })
+    }
+    next()
+  }
+
+  function closeAll (connections, done) {
+    async.series(connections.map(function (c) {
+      return function (asyncDone) {
+        c.close(function () {
+          asyncDone()
+        })
+      }
+    }), function () {
+      done()
+    })
+  }
+
+  test('delays on as many connections as there are workers overlap without starving fs', function (testDone) {
+    var fs = require('fs')
+    var count = Math.min(sql.getWorkerThreads(), 6)
+
+    assert.strictEqual(sql.setWorkerThreads(2), false, 'pool size is fixed once started')
+
+    openMany(count, function (connections) {
+      var start = Date.now()
+      var remaining = count
+      var statMs = -1
+      connections.forEach(function (conn) {
+        conn.query('waitfor delay \'00:00:01\';', function (err) {
+          assert.ifError(err)
+          remaining -= 1
+          if (remaining === 0) {
+            var elapsed = Date.now() - start
+            assert(elapsed < 1800, count + ' delays of 1000ms took ' + elapsed)
+            assert(statMs >= 0 && statMs < 1000, 'fs work waited behind the database ' + statMs)
+            closeAll(connections, testDone)
+          }
+        })
+      })
+      fs.stat(__filename, function (err) {
+        assert.ifError(err)
+        statMs = Date.now() - start
+      })
+    })
+  })
+
+  test('a slow statement does not hold back a connection queued to the same worker', function (testDone) {
+    // connections opened in turn are queued to the workers in turn, so the first and the
+    // last of one more than there are workers share one.
+    var workers = sql.getWorkerThreads()
+    openMany(workers + 1, function (connections) {
+      var start = Date.now()
+      var fastMs = -1
+      connections[0].query('waitfor delay \'00:00:03\';', function (err) {
+        assert.ifError(err)
+        assert(fastMs >= 0 && fastMs < 2000, 'statement waited behind the slow one ' + fastMs)
+        closeAll(connections, testDone)
+      })
+      connections[workers].query('waitfor delay \'00:00:01\';', function (err) {
+        assert.ifError(err)
+        fastMs = Date.now() - start
+      })
+    })
+  })
+
+  test('pool prewarms the floor, queues waiters beyond the ceiling and reuses connections', function (testDone) {
+    var pool = sql.Pool({
+      connectionString: connStr,
+      floor: 2,
+      ceiling: 2,
+      acquireTimeoutMs: 10000
+    })
+    pool.open(function (err) {
+      assert.ifError(err)
+      assert.strictEqual(pool.getMetrics().idle, 2)
+      var ids = []
+      var remaining = 3
+
+      function work (conn, done) {
+        ids.push(conn.id)
+        conn.isAlive(function (err, alive) {
+          assert.ifError(err)
+          assert.strictEqual(alive, true)
+          conn.query('waitfor delay \'00:00:00.200\'; select 1 as n', done)
+        })
+      }
+
+      function finished (err, res) {
+        assert.ifError(err)
+        assert.deepEqual(res, [{ n: 1 }])
+        remaining -= 1
+        if (remaining > 0) {
+          return
+        }
+        var metrics = pool.getMetrics()
+        assert.strictEqual(metrics.acquires, 3)
+        assert.strictEqual(metrics.created, 2)
+        assert.strictEqual(metrics.busy, 0)
+        assert.strictEqual(ids.filter(function (id, i) {
+          return ids.indexOf(id) === i
+        }).length, 2)
+        pool.close(function () {
+          testDone()
+        })
+      }
+
+      pool.use(work, finished)
+      pool.use(work, finished)
+      pool.use(work, finished)
+      assert.strictEqual(pool.getMetrics().waiting, 1)
+    })
+  })
+
+  test('pool use keeps the connection until the last result of a query passed done', function (testDone) {
+    var pool = sql.Pool({
+      connectionString: connStr,
+      floor: 1,
+      ceiling: 1
+    })
+    pool.open(function (err) {
+      assert.ifError(err)
+      var calls = []
+
+      function work (conn, done) {
+        conn.query('select 1 as n; select 2 as n', done)
+      }
+
+      pool.use(work, function (err, res, more) {
+        assert.ifError(err)
+        calls.push(more)
+        assert.strictEqual(pool.getMetrics().busy, more ? 1 : 0)
+        if (more) {
+          return
+        }
+        assert.deepEqual(calls, [true, false])
+        pool.close(function () {
+          testDone()
+        })
+      })
+    })
+  })
+
+  test('statements on a mars connection run alongside each other', function (testDone) {
+    sql.open({ conn_str: connStr, mars: true }, function (err, conn) {
+      assert.ifError(err)
+      var order = []
+
+      function done () {
+        if (order.length < 2) {
+          return
+        }
+        assert.deepEqual(order, ['quick', 'slow'])
+        conn.close(function () {
+          testDone()
+        })
+      }
+
+      conn.query('waitfor delay \'00:00:01\'; select 1 as n', function (err, res) {
+        assert.ifError(err)
+        assert.deepEqual(res, [{ n: 1 }])
+        order.push('slow')
+        done()
+      })
+      conn.query('select 2 as n', function (err, res) {
+        assert.ifError(err)
+        assert.deepEqual(res, [{ n: 2 }])
+        order.push('quick')
+        done()
+      })
+    })
+  })
+
+  test('transaction commands on a mars connection wait for running statements', function (testDone) {
+    sql.open({ conn_str: connStr, mars: true }, function (err, conn) {
+      assert.ifError(err)
+      var order = []
+      conn.query('create table #mars_txn (n int)', function (err) {
+        assert.ifError(err)
+        conn.query('waitfor delay \'00:00:01\'; insert into #mars_txn values (1)', function (err) {
+          assert.ifError(err)
+          order.push('running')
+        })
+        conn.beginTransaction(function (err) {
+          assert.ifError(err)
+          order.push('begin')
+        })
+        conn.query('insert into #mars_txn values (2)', function (err) {
+          assert.ifError(err)
+          order.push('held')
+        })
+        conn.rollback(function (err) {
+          assert.ifError(err)
+          order.push('rollback')
+          conn.query('select n from #mars_txn', function (err, res) {
+            assert.ifError(err)
+            assert.deepEqual(order, ['running', 'begin', 'held', 'rollback'])
+            assert.deepEqual(res, [{ n: 1 }])
+            conn.close(function () {
+              testDone()
+            })
+          })
+        })
+      })
+    })
+  })
+
+  test('a file import on a mars connection waits for running statements', function (testDone) {
+    var fs = require('fs')
+    var os = require('os')
+    var path = require('path')
+    var file = path.join(os.tmpdir(), 'msnodesqlv8-mars-import-' + process.pid + '.csv')
+    fs.writeFileSync(file, 'n\r\n1\r\n2\r\n')
+    sql.open({ conn_str: connStr, mars: true }, function (err, conn) {
+      assert.ifError(err)
+      var order = []
+      conn.query('if object_id(\'dbo.mars_import\', \'U\') is not null drop table dbo.mars_import; create table mars_import (n int)', function (err) {
+        assert.ifError(err)
+        conn.query('waitfor delay \'00:00:01\'; select 1 as n', function (err) {
+          assert.ifError(err)
+          order.push('running')
+        })
+        conn.importFile(file, 'mars_import', {}, function (err, copied) {
+          fs.unlinkSync(file)
+          assert.ifError(err)
+          assert.strictEqual(copied, 2)
+          order.push('import')
+          assert.deepEqual(order, ['running', 'import'])
+          conn.close(function () {
+            testDone()
+          })
+        })
+      })
+    })
+  })
+
+  // the classes and the worker count are fixed once this process has sent an operation, so
+  // each scheduler test runs its queries in a fresh node process configured to suit. The
+  // child opens the connections, holds every worker with a delay so the queries queue up
+  // behind it, and reports the order the queries completed in and the time taken. queryAll
+  // runs each query as a single operation, so the completion order is the order picked.
+
+  function runScheduled (setup, done) {
+    var childProcess = require('child_process')
+    var path = require('path')
+    var source = [
+      'var sql = require(' + JSON.stringify(path.join(__dirname, '..')) + ')',
+      'var setup = ' + JSON.stringify(setup),
+      'sql.setWorkerThreads(setup.workers)',
+      'sql.setSchedulerClasses(setup.classes)',
+      'var blockers = []',
+      'var conns = []',
+      'var order = []',
+      'function opened (list, count, next) {',
+      '  if (list.length === count) { next(); return }',
+      '  sql.open(process.env.CONN_STR, function (err, conn) {',
+      '    if (err) { console.log(JSON.stringify({ error: err.message })); process.exit(1) }',
+      '    list.push(conn)',
+      '    opened(list, count, next)',
+      '  })',
+      '}',
+      'opened(blockers, setup.workers, function () {',
+      '  opened(conns, setup.queries.length, function () {',
+      '    var start = Date.now()',
+      '    var remaining = setup.queries.length',
+      '    blockers.forEach(function (b) { b.queryAll("waitfor delay \'00:00:00.500\'", function () {}) })',
+      '    setTimeout(function () {',
+      '      setup.queries.forEach(function (q, i) {',
+      '        conns[i].queryAll({ query_str: q.sql || "select 1 as n", query_priority: q.priority, query_tenant: q.tenant }, function (err) {',
+      '          if (err) { console.log(JSON.stringify({ error: err.message })); process.exit(1) }',
+      '          order.push(i)',
+      '          if (--remaining === 0) {',
+      '            console.log(JSON.stringify({ order: order, elapsed: Date.now() - start }))',
+      '            process.exit(0)',
+      '          }',
+      '        })',
+      '      })',
+      '    }, 100)',
+      '  })',
+      '})'
+    ].join('\n')
+    var env = Object.assign({}, process.env, { CONN_STR: connStr })
+    childProcess.execFile(process.execPath, ['-e', source], { env: env }, function (err, stdout) {
+      assert.ifError(err)
+      var res = JSON.parse(stdout.trim().split('\n').pop())
+      assert.ifError(res.error)
+      done(res)
+    })
+  }
+
+  function scheduled (count, priority, tenant, sqlText) {
+    var queries = []
+    for (var i = 0; i < count; ++i) {
+      queries.push({ priority: priority, tenant: tenant, sql: sqlText })
+    }
+    return queries
+  }
+
+  test('scheduler classes take turns in proportion to their weight', function (testDone) {
+    var queries = scheduled(20, 'batch', '').concat(scheduled(20, 'api', ''))
+    runScheduled({
+      workers: 1,
+      classes: [{ name: 'api', weight: 3 }, { name: 'batch', weight: 1 }],
+      queries: queries
+    }, function (res) {
+      assert.strictEqual(res.order.length, 40)
+      var api = res.order.slice(0, 20).filter(function (i) {
+        return queries[i].priority === 'api'
+      }).length
+      assert.strictEqual(api, 15)
+      testDone()
+    })
+  })
+
+  test('scheduler serves the tenants of a class round robin', function (testDone) {
+    var queries = scheduled(4, 'default', 'acme').concat(scheduled(4, 'default', 'globex'))
+    runScheduled({
+      workers: 1,
+      classes: [{ name: 'default', weight: 1 }],
+      queries: queries
+    }, function (res) {
+      assert.deepEqual(res.order.map(function (i) {
+        return queries[i].tenant
+      }), ['acme', 'globex', 'acme', 'globex', 'acme', 'globex', 'acme', 'globex'])
+      testDone()
+    })
+  })
+
+  test('scheduler runs no more of a capped class at once than its cap across workers', function (testDone) {
+    var queries = scheduled(4, 'bulk', '', 'waitfor delay \'00:00:00.500\'; select 1 as n')
+    runScheduled({
+      workers: 4,
+      classes: [{ name: 'api', weight: 1 }, { name: 'bulk', weight: 1, maxRunning: 1 }],
+      queries: queries
+    }, function (res) {
+      // the blockers hold the workers for 500ms, then the four delays run one at a time.
+      assert(res.elapsed >= 2400, 'capped delays overlapped, took ' + res.elapsed)
+      testDone()
+    })
+  })
+
+  test('operations tagged with a priority class and tenant are counted in the scheduler stats', function (testDone) {
+    assert.strictEqual(sql.setSchedulerClasses([{ name: 'api', weight: 4 }]), false, 'classes are fixed once started')
+    var before = sql.getSchedulerStats()
+    assert.strictEqual(before[0].name, 'default')
+    var remaining = 4
+
+    function done (err, res) {
+      assert.ifError(err)
+      assert.deepEqual(res, [{ n: 1 }])
+      remaining -= 1
+      if (remaining > 0) {
+        return
+      }
+      var after = sql.getSchedulerStats()
+      assert(after[0].dispatched >= before[0].dispatched + 4)
+      assert(after[0].waitMsMax >= after[0].waitMsAvg)
+      assert.strictEqual(after[0].queued, 0)
+      testDone()
+    }
+
+    ['acme', 'acme', 'globex', 'globex'].forEach(function (tenant) {
+      theConnection.query({
+        query_str: 'select 1 as n',
+        query_priority: 'default',
+        query_tenant: tenant
+      }, done)
+    })
+  })
 })
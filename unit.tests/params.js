@@ -446,6 +446,61 @@ suite('params', function () {
       })
   })
 
+  test('insert rows packed into a single Buffer', function (testDone) {
+    var layout = sql.RowLayout([
+      {name: 'int_test', type: 'int'},
+      {name: 'string_test', type: 'varchar', length: 10}
+    ])
+    var strings = ['one', null, 'three']
+    var buffer = Buffer.alloc(layout.row_size * strings.length)
+
+    function writeInd (offset, v) {
+      buffer.writeInt32LE(v, offset)
+      if (layout.ind_size === 8) {
+        buffer.writeInt32LE(v < 0 ? -1 : 0, offset + 4)
+      }
+    }
+
+    strings.forEach(function (s, i) {
+      var row = i * layout.row_size
+      var intCol = layout.columns[0]
+      var strCol = layout.columns[1]
+      buffer.writeInt32LE(i + 1, row + intCol.offset)
+      writeInd(row + intCol.ind_offset, 4)
+      if (s === null) {
+        writeInd(row + strCol.ind_offset, -1)
+      } else {
+        buffer.write(s, row + strCol.offset, 'ascii')
+        writeInd(row + strCol.ind_offset, s.length)
+      }
+    })
+
+    testBoilerPlate(
+      'packed_param_test',
+      {'int_test': 'int', 'string_test': 'varchar(10)'},
+      function (done) {
+        var insert = 'INSERT INTO packed_param_test (int_test, string_test) VALUES (?, ?)'
+        theConnection.query(insert, [sql.PackedRows(buffer, layout, strings.length)], function (e) {
+          assert.ifError(e)
+          done()
+        })
+      },
+
+      function (done) {
+        theConnection.query('SELECT int_test, string_test FROM packed_param_test order by id', function (e, r) {
+          assert.ifError(e)
+          var expected = strings.map(function (s, i) {
+            return {int_test: i + 1, string_test: s}
+          })
+          assert.deepEqual(expected, r)
+          done()
+        })
+      },
+      function () {
+        testDone()
+      })
+  })
+
   test('insert a bool as a parameter', function (testDone) {
     testBoilerPlate('bool_param_test',
       {'bool_test': 'bit'},
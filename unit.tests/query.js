@@ -897,4 +897,160 @@ suite('query', function () {
       testDone()
     })
   })
+
+  test('export query rows as ndjson and csv to a writable', function (testDone) {
+    var stream = require('stream')
+    var sqlText = 'select 1 as id, N\'a,"b"\' as txt, cast(1.5 as decimal(5,2)) as amount, cast(null as int) as missing union all select 2, N\'é\', -0.25, 7'
+
+    function collector () {
+      var chunks = []
+      var w = new stream.Writable({
+        write: function (chunk, encoding, cb) {
+          chunks.push(chunk)
+          cb()
+        }
+      })
+      w.text = function () {
+        return Buffer.concat(chunks).toString('utf8')
+      }
+      return w
+    }
+
+    var fns = [
+      function (asyncDone) {
+        var w = collector()
+        theConnection.exportQuery(sqlText, { format: 'ndjson', writable: w }, function (err, rows) {
+          assert.ifError(err)
+          assert.strictEqual(rows, 2)
+          var parsed = w.text().split('\n').filter(function (l) {
+            return l.length > 0
+          }).map(function (l) {
+            return JSON.parse(l)
+          })
+          assert.deepEqual(parsed, [
+            { id: 1, txt: 'a,"b"', amount: 1.5, missing: null },
+            { id: 2, txt: 'é', amount: -0.25, missing: 7 }
+          ])
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        var w = collector()
+        theConnection.exportQuery(sqlText, { format: 'csv', writable: w }, function (err, rows) {
+          assert.ifError(err)
+          assert.strictEqual(rows, 2)
+          var lines = w.text().split('\r\n')
+          assert.strictEqual(lines[0], 'id,txt,amount,missing')
+          assert.strictEqual(lines[1], '1,"a,""b""",1.50,')
+          assert.strictEqual(lines[2], '2,é,-0.25,7')
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  test('export every result set of a query as csv to a file descriptor', function (testDone) {
+    var fs = require('fs')
+    var os = require('os')
+    var path = require('path')
+    var file = path.join(os.tmpdir(), 'msnodesqlv8-export-' + process.pid + '.csv')
+    var sqlText = 'select 1 as id, cast(0.5 as decimal(3,1)) as half union all select 2, -0.5; select N\'x\' as txt'
+    var fd = fs.openSync(file, 'w')
+    var events = []
+
+    var q = theConnection.exportQuery(sqlText, { format: 'csv', fd: fd }, function (err, rows) {
+      fs.closeSync(fd)
+      assert.ifError(err)
+      assert.strictEqual(rows, 3)
+      var lines = fs.readFileSync(file, 'utf8').split('\r\n')
+      fs.unlinkSync(file)
+      assert.deepEqual(lines, ['id,half', '1,0.5', '2,-0.5', 'txt', 'x', ''])
+      assert.deepEqual(events, ['submitted', 'meta', 'meta', 'done'])
+      testDone()
+    })
+    q.on('submitted', function () {
+      events.push('submitted')
+    })
+    q.on('meta', function () {
+      events.push('meta')
+    })
+    q.on('done', function () {
+      events.push('done')
+    })
+  })
+
+  test('queryAll returns every result set in one call and honours maxRows and maxBytes', function (testDone) {
+    var sqlText = 'select 1 as id, N\'one\' as txt union all select 2, N\'two\'; select replicate(cast(N\'x\' as nvarchar(max)), 9000) as big'
+
+    var fns = [
+      function (asyncDone) {
+        theConnection.queryAll(sqlText, function (err, sets, outputParams, truncated) {
+          assert.ifError(err)
+          assert.strictEqual(truncated, false)
+          assert.strictEqual(sets.length, 2)
+          assert.deepEqual(sets[0].meta.map(function (m) {
+            return m.name
+          }), ['id', 'txt'])
+          assert.deepEqual(sets[0].rows, [[1, 'one'], [2, 'two']])
+          assert.strictEqual(sets[1].rows[0][0].length, 9000)
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        theConnection.queryAll('select ? as v union all select 2 union all select 3', [1], { maxRows: 2 }, function (err, sets, outputParams, truncated) {
+          assert.ifError(err)
+          assert.strictEqual(truncated, true)
+          assert.deepEqual(sets[0].rows, [[1], [2]])
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        // each row is 2000 bytes of utf16, so a third would take the total past the cap.
+        var rowText = 'select replicate(N\'x\', 1000) as pad'
+        theConnection.queryAll([rowText, rowText, rowText].join(' union all '), [], { maxBytes: 5000 }, function (err, sets, outputParams, truncated) {
+          assert.ifError(err)
+          assert.strictEqual(truncated, true)
+          assert.strictEqual(sets[0].rows.length, 2)
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        theConnection.queryAll('select 1 as ok', function (err, sets) {
+          assert.ifError(err)
+          assert.deepEqual(sets[0].rows, [[1]])
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  test('queries queued on one connection deliver their results in order', function (testDone) {
+    var expected = [1, 2, 3, 4, 5]
+    var order = []
+
+    expected.forEach(function (n) {
+      var sqlText = 'select top ' + n + ' ' + n + ' as n, replicate(\'x\', 5000) as pad from sys.objects'
+      theConnection.query(sqlText, function (err, res) {
+        assert.ifError(err)
+        assert.strictEqual(res.length, n)
+        res.forEach(function (row) {
+          assert.strictEqual(row.n, n)
+          assert.strictEqual(row.pad.length, 5000)
+        })
+        order.push(n)
+        if (order.length === expected.length) {
+          assert.deepEqual(order, expected)
+          testDone()
+        }
+      })
+    })
+  })
 })
@@ -65,16 +65,48 @@ suite('querycancel', function () {
     })
   })
 
-  test('cancel single waitfor on non polling query - expect cancel error and query to complete', function (testDone) {
-    var q = theConnection.query('waitfor delay \'00:00:3\';', function (err) {
-      assert(!err)
+  test('polling query that is not cancelled completes with its results', function (testDone) {
+    var start = Date.now()
+    theConnection.query(sql.PollingQuery('waitfor delay \'00:00:01\'; select 1 as n'), function (err, res, more) {
+      assert.ifError(err)
+      if (more) {
+        return
+      }
+      assert.deepEqual(res, [{ n: 1 }])
+      assert(Date.now() - start < 1500, 'completion was not noticed promptly')
+      testDone()
+    })
+  })
+
+  test('cancel single waitfor on non polling query - expect Operation canceled', function (testDone) {
+    var q = theConnection.query('waitfor delay \'00:00:20\';', function (err) {
+      assert(err)
+      assert(err.message.indexOf('Operation canceled') > 0)
       testDone()
     })
 
     theConnection.cancelQuery(q, function (err) {
+      assert(!err)
+    })
+  })
+
+  test('abort signal cancels a running query - expect Operation canceled', function (testDone) {
+    if (typeof AbortController === 'undefined') {
+      testDone()
+      return
+    }
+    var controller = new AbortController()
+    theConnection.query({
+      query_str: 'waitfor delay \'00:00:20\';',
+      signal: controller.signal
+    }, function (err) {
       assert(err)
-      assert(err.message.indexOf('only supported') > 0)
+      assert(err.message.indexOf('Operation canceled') > 0)
+      testDone()
     })
+    setTimeout(function () {
+      controller.abort()
+    }, 200)
   })
 
   test('cancel single waitfor using notifier - expect Operation canceled', function (testDone) {
@@ -234,6 +266,58 @@ suite('querycancel', function () {
     })
   })
 
+  test('cancel a prepared query while its rows are read, then run it again', function (testDone) {
+    var s = 'select top (?) a.object_id from sys.all_objects a cross join sys.all_objects b'
+    var prepared
+
+    var fns = [
+      function (asyncDone) {
+        theConnection.prepare(s, function (err, pq) {
+          assert(!err)
+          prepared = pq
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var cancelled = false
+        var q = prepared.preparedQuery([100000], function (err) {
+          assert(err)
+          assert(err.message.indexOf('Operation canceled') > 0)
+          asyncDone()
+        })
+
+        q.on('row', function () {
+          if (cancelled) {
+            return
+          }
+          cancelled = true
+          q.cancelQuery(function (err) {
+            assert.ifError(err)
+          })
+        })
+      },
+
+      function (asyncDone) {
+        prepared.preparedQuery([3], function (err, res) {
+          assert.ifError(err)
+          assert.strictEqual(res.length, 3)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        prepared.free(function () {
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
   test('cancel a call to proc that waits for delay of input param.', function (testDone) {
     var spName = 'test_spwait_for'
 
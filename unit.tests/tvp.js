@@ -3,6 +3,7 @@
 
 var supp = require('../samples/typescript/demo-support')
 var assert = require('assert')
+var stream = require('stream')
 
 suite('tvp', function () {
   var theConnection
@@ -277,6 +278,36 @@ suite('tvp', function () {
     })
   })
 
+  test('use tvp simple test type select test with a single row', function (testDone) {
+    var tableName = 'TestTvp'
+    var table
+
+    var fns = [
+
+      function (asyncDone) {
+        setupSimpleType(tableName, function (t) {
+          table = t
+          table.addRowsFromObjects(vec.slice(0, 1))
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tp = sql.TvpFromTable(table)
+        table.rows = []
+        theConnection.query('select * from ?;', [tp], function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(res, vec.slice(0, 1))
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
   test('use tvp simple test type insert test', function (testDone) {
     var tableName = 'TestTvp'
     var table
@@ -314,6 +345,184 @@ suite('tvp', function () {
     })
   })
 
+  test('use tvp streamed from rows in chunks insert test', function (testDone) {
+    var tableName = 'TestTvp'
+    var table
+
+    var fns = [
+
+      function (asyncDone) {
+        setupSimpleType(tableName, function (t) {
+          table = t
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tp = sql.TvpFromStream(table, vec, 1)
+        theConnection.query('exec insertTestTvp @tvp = ?;', [tp], function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select * from ' + tableName, function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(vec, res)
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
+  function streamedRows (count) {
+    var rows = []
+    for (var i = 0; i < count; ++i) {
+      rows.push({
+        username: 'user' + i + new Array(i % 7 + 1).join('x'),
+        age: 20 + i,
+        salary: i * 2
+      })
+    }
+    return rows
+  }
+
+  function streamedInsertTest (rows, source, testDone) {
+    var tableName = 'TestTvp'
+    var table
+
+    var fns = [
+
+      function (asyncDone) {
+        setupSimpleType(tableName, function (t) {
+          table = t
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tp = sql.TvpFromStream(table, source, 4)
+        theConnection.query('exec insertTestTvp @tvp = ?;', [tp], function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('select * from ' + tableName + ' order by age', function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(res, rows)
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  }
+
+  test('use tvp streamed from a Readable in chunks of several rows', function (testDone) {
+    var rows = streamedRows(23)
+    var next = 0
+    var source = new stream.Readable({
+      objectMode: true,
+      read: function () {
+        this.push(next < rows.length ? rows[next++] : null)
+      }
+    })
+    streamedInsertTest(rows, source, testDone)
+  })
+
+  test('use tvp streamed from an async iterator in chunks of several rows', function (testDone) {
+    if (!Symbol.asyncIterator) {
+      testDone()
+      return
+    }
+    var rows = streamedRows(23)
+    var next = 0
+    var source = {}
+    source[Symbol.asyncIterator] = function () {
+      return {
+        next: function () {
+          return new Promise(function (resolve) {
+            setImmediate(function () {
+              resolve(next < rows.length ? { value: rows[next++], done: false } : { done: true })
+            })
+          })
+        }
+      }
+    }
+    streamedInsertTest(rows, source, testDone)
+  })
+
+  test('use tvp with BigInt values for a decimal column', function (testDone) {
+    if (typeof global.BigInt !== 'function') {
+      testDone()
+      return
+    }
+    var tableTypeName = 'TestTvpDecimalType'
+    var amounts = ['12345678901234567890123456789', '-98765432109876543210', '0']
+    var table
+
+    var fns = [
+
+      function (asyncDone) {
+        var sql = 'IF TYPE_ID(N\'' + tableTypeName + '\') IS not NULL'
+        sql += ' drop type ' + tableTypeName
+        theConnection.query(sql, function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.query('CREATE TYPE ' + tableTypeName + ' AS TABLE (id int, amount decimal(38,0))', function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        theConnection.getUserTypeTable(tableTypeName, function (err, t) {
+          assert.ifError(err)
+          table = t
+          table.addRowsFromObjects(amounts.map(function (a, i) {
+            return {
+              id: i,
+              amount: global.BigInt(a)
+            }
+          }))
+          asyncDone()
+        })
+      },
+
+      function (asyncDone) {
+        var tp = sql.TvpFromTable(table)
+        table.rows = []
+        theConnection.query('select id, cast(amount as varchar(50)) as amount from ? order by id;', [tp], function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(res, amounts.map(function (a, i) {
+            return {
+              id: i,
+              amount: a
+            }
+          }))
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(fns, function () {
+      testDone()
+    })
+  })
+
   test('use tvp to select from table type complex object Employee type', function (testDone) {
     var tableName = 'Employee'
     var bulkMgr
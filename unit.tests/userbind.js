@@ -595,6 +595,53 @@ suite('userbind', function () {
     })
   })
 
+  test('user bind Numeric from decimal string is exact', function (testDone) {
+    var params = {
+      query: 'declare @v decimal(38,5) = ?; select cast(@v as varchar(50)) as v',
+      min: '-123456789012345678901234567890.12345',
+      max: '123456789012345678901234567890.12345',
+      setter: function (v) {
+        return sql.Numeric(v, 38, 5)
+      }
+    }
+    testUserBind(params, function (err, res) {
+      assert.ifError(err)
+      compare(params, res)
+      testDone()
+    })
+  })
+
+  test('user bind Numeric array with mixed scales', function (testDone) {
+    var values = [1.5, 2.25, 0.125, null]
+    var sequence = [
+      function (asyncDone) {
+        theConnection.query('create table #numeric_array (d decimal(10,3))', function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        theConnection.query('insert into #numeric_array (d) values (?)', [sql.Numeric(values)], function (err) {
+          assert.ifError(err)
+          asyncDone()
+        })
+      },
+      function (asyncDone) {
+        theConnection.query('select d from #numeric_array', function (err, res) {
+          assert.ifError(err)
+          assert.deepEqual(res, values.map(function (v) {
+            return {d: v}
+          }))
+          asyncDone()
+        })
+      }
+    ]
+
+    async.series(sequence, function () {
+      testDone()
+    })
+  })
+
   test('user bind Int', function (testDone) {
     var params = {
       query: 'declare @v int = ?; select @v as v',